@@ -31,6 +31,8 @@
 #include <task.h>
 #include <event_groups.h>
 #include <timers.h>
+#include <stream_buffer.h>
+#include <message_buffer.h>
 #include "stdbool.h"
 #if !defined (COMPONENT_CAT5)
 #include <cmsis_compiler.h>
@@ -56,6 +58,24 @@ extern "C" {
 #define CY_RTOS_MAX_SUSPEND_NESTING 3              /**< Maximum nesting allowed for calls
                                                         to scheduler suspend from ISR */
 #endif
+/** Number of bytes needed by \ref cy_rtos_queue_init_static for the queue control block and
+ * length items of itemsize bytes */
+#define CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize) \
+    (((sizeof(StaticQueue_t) + CY_RTOS_ALIGNMENT_MASK) & ~CY_RTOS_ALIGNMENT_MASK) + \
+     ((length) * (itemsize)))
+/** Stream and message buffers use the FreeRTOS ones */
+#define CY_RTOS_NATIVE_STREAM_BUFFER
+/** Number of bytes needed by \ref cy_rtos_stream_buffer_init_static or \ref
+ * cy_rtos_message_buffer_init_static for the stream buffer control block and size bytes */
+#define CY_RTOS_STREAM_BUFFER_STORAGE_SIZE(size) \
+    (((sizeof(StaticStreamBuffer_t) + CY_RTOS_ALIGNMENT_MASK) & ~CY_RTOS_ALIGNMENT_MASK) + \
+     (size) + 1U)
+/** Number of bytes of a message buffer taken by the length stored with each message */
+#if defined(configMESSAGE_BUFFER_LENGTH_TYPE)
+#define CY_RTOS_MESSAGE_LENGTH_SIZE (sizeof(configMESSAGE_BUFFER_LENGTH_TYPE))
+#else
+#define CY_RTOS_MESSAGE_LENGTH_SIZE (sizeof(size_t))
+#endif
 /******************************************************
 *                   Enumerations
 ******************************************************/
@@ -87,11 +107,24 @@ typedef SemaphoreHandle_t  cy_semaphore_t;
 typedef TaskHandle_t       cy_thread_t;
 typedef EventGroupHandle_t cy_event_t;
 typedef TimerHandle_t      cy_timer_t;
+typedef StreamBufferHandle_t  cy_stream_buffer_t;
+typedef MessageBufferHandle_t cy_message_buffer_t;
 typedef uint32_t           cy_timer_callback_arg_t;
 typedef void*              cy_thread_arg_t;
 typedef uint32_t           cy_time_t;
 typedef BaseType_t         cy_rtos_error_t;
 
+// Thread control block, allocated by cy_rtos_thread_create or provided to
+// cy_rtos_thread_create_static
+typedef struct
+{
+    StaticTask_t      task;
+    StaticSemaphore_t sema_mem;
+    SemaphoreHandle_t sema;
+    uint32_t          magic;
+    void*             memptr;
+} cy_thread_cb_t;
+
 #if defined(CYHAL_DRIVER_AVAILABLE_LPTIMER) && (CYHAL_DRIVER_AVAILABLE_LPTIMER)
 /** Stores a reference to an lptimer instance for use with vApplicationSleep().
  *
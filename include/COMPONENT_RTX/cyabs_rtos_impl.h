@@ -44,6 +44,11 @@ extern "C"
 #define CY_RTOS_ALIGNMENT           0x00000008UL /** Minimum alignment for RTOS objects */
 #define CY_RTOS_ALIGNMENT_MASK      0x00000007UL /** Mask for checking the alignment of
                                                      created RTOS objects */
+/** Number of bytes needed by \ref cy_rtos_queue_init_static for the queue control block and
+ * length items of itemsize bytes */
+#define CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize) \
+    (((osRtxMessageQueueCbSize + sizeof(uint32_t) + CY_RTOS_ALIGNMENT_MASK) & \
+      ~CY_RTOS_ALIGNMENT_MASK) + osRtxMessageQueueMemSize((length), (itemsize)))
 
 
 /******************************************************
@@ -76,6 +81,14 @@ typedef void*              cy_timer_callback_arg_t; /** Argument passed to the t
 typedef uint32_t           cy_time_t;               /** Time in milliseconds */
 typedef osStatus_t         cy_rtos_error_t;         /** CMSIS definition of a error status */
 
+/** Thread control block, allocated by cy_rtos_thread_create or provided to
+ * cy_rtos_thread_create_static */
+typedef struct
+{
+    osRtxThread_t thread;                           /** RTX thread control block */
+    uint32_t      magic;                            /** Identifies caller provided memory */
+} cy_thread_cb_t;
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
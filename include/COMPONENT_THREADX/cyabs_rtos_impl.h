@@ -49,6 +49,17 @@ extern "C"
 #define CY_RTOS_ALIGNMENT       0x00000008UL     /**< Minimum alignment for RTOS objects */
 #define CY_RTOS_ALIGNMENT_MASK  0x00000007UL     /**< Checks for 8-byte alignment */
 
+/** Number of words in a queue message holding itemsize bytes. ThreadX messages are 1, 2, 4, 8 or
+ * 16 words long. */
+#define CY_RTOS_QUEUE_MESSAGE_WORDS(itemsize)                                       \
+    ((((itemsize) + sizeof(ULONG) - 1U) / sizeof(ULONG) <= 1U) ? 1U :               \
+     (((itemsize) + sizeof(ULONG) - 1U) / sizeof(ULONG) <= 2U) ? 2U :               \
+     (((itemsize) + sizeof(ULONG) - 1U) / sizeof(ULONG) <= 4U) ? 4U :               \
+     (((itemsize) + sizeof(ULONG) - 1U) / sizeof(ULONG) <= 8U) ? 8U : 16U)
+/** Number of bytes needed by \ref cy_rtos_queue_init_static for length items of itemsize bytes */
+#define CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize) \
+    ((length) * CY_RTOS_QUEUE_MESSAGE_WORDS(itemsize) * sizeof(ULONG))
+
 
 /******************************************************
 *                 Type Definitions
@@ -95,6 +106,15 @@ typedef struct
     TX_TIMER tx_timer;
 } cy_timer_t;
 
+/** Thread control block, allocated by cy_rtos_thread_create or provided to
+ * cy_rtos_thread_create_static */
+typedef struct
+{
+    TX_THREAD thread;
+    uint32_t  magic;
+    void*     memptr;
+} cy_thread_cb_t;
+
 typedef TX_THREAD*              cy_thread_t;
 typedef ULONG                   cy_thread_arg_t;
 typedef TX_MUTEX                cy_mutex_t;
@@ -57,6 +57,10 @@ extern "C"
 // TODO: Replace these with proper values for the target RTOS
 #define CY_RTOS_MIN_STACK_SIZE      300                     /**< Minimum stack size */
 #define CY_RTOS_ALIGNMENT_MASK      0x00000007UL            /**< Checks for 8-bit alignment */
+/** Number of bytes needed by \ref cy_rtos_queue_init_static for a queue of length items of
+ * itemsize bytes, including any control block of the queue */
+#define CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize) \
+    (/* TODO: Replace with RTOS specific size*/ (length) * (itemsize))
 
 
 /******************************************************
@@ -102,6 +106,8 @@ typedef void* /* TODO: Replace with RTOS specific type*/ cy_timer_callback_arg_t
 typedef void* /* TODO: Replace with RTOS specific type*/ cy_time_t;
 /** Alias for the RTOS specific definition of a error status */
 typedef void* /* TODO: Replace with RTOS specific type*/ cy_rtos_error_t;
+/** Alias for the RTOS specific memory of a thread created with \ref cy_rtos_thread_create_static */
+typedef void* /* TODO: Replace with RTOS specific type*/ cy_thread_cb_t;
 
 /** \} group_abstraction_rtos_port */
 
@@ -49,6 +49,37 @@ extern "C" {
 #define CY_WORKER_THREAD_DEFAULT_NAME               "CYWorker"
 /** Default number of work items in the queue */
 #define CY_WORKER_DEFAULT_ENTRIES                   (16)
+/** Default number of threads in a worker pool */
+#define CY_WORKER_POOL_DEFAULT_THREADS              (2)
+#if !defined(CY_WORKER_POOL_MAX_THREADS)
+/** Maximum number of threads in a worker pool */
+#define CY_WORKER_POOL_MAX_THREADS                  (4)
+#endif
+/** Default time an elastic pool thread above the minimum stays idle before it retires */
+#define CY_WORKER_POOL_DEFAULT_IDLE_MS              (1000)
+#if !defined(CY_WORKER_THREAD_MAX_BATCH)
+/** Maximum number of work items a worker thread takes from its queue per wakeup */
+#define CY_WORKER_THREAD_MAX_BATCH                  (8)
+#endif
+#if !defined(CY_WORKER_THREAD_MAX_LANES)
+/** Maximum number of priority lanes of a worker thread */
+#define CY_WORKER_THREAD_MAX_LANES                  (4)
+#endif
+#if !defined(CY_WORKER_GRAPH_MAX_SUCCESSORS)
+/** Maximum number of stages that can depend on one stage of a \ref cy_worker_graph_t */
+#define CY_WORKER_GRAPH_MAX_SUCCESSORS              (4)
+#endif
+#if !defined(CY_WORKER_THREAD_MAX_PAYLOAD)
+/** Maximum number of payload bytes that can be copied into a queue entry with
+ * \ref cy_worker_thread_enqueue_payload */
+#define CY_WORKER_THREAD_MAX_PAYLOAD                (16)
+#endif
+#if !defined(CY_WORKER_THREAD_MAX_CANCEL)
+/** Maximum number of \ref cy_worker_thread_cancel calls that can still have queued work for the
+ * worker thread to drop at the same time. If set to 0, work queued on the lanes cannot be
+ * cancelled and queue entries do not hold a cancel epoch. */
+#define CY_WORKER_THREAD_MAX_CANCEL                 (0)
+#endif
 
 /** Additional work cannot be enqueued because the worker thread has been terminated.
  * This can occur if \ref cy_worker_thread_create was not called or \ref cy_worker_thread_delete was
@@ -57,19 +88,159 @@ extern "C" {
 #define CY_WORKER_THREAD_ERR_THREAD_INVALID          \
     CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 32)
 
+/** \ref cy_worker_thread_cancel found no pending work to cancel */
+#define CY_WORKER_THREAD_ERR_NOT_FOUND               \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 33)
+
+/** \ref cy_worker_thread_cancel did nothing because work is queued on the lanes and no
+ * tombstone is free to mark it, see \ref CY_WORKER_THREAD_MAX_CANCEL */
+#define CY_WORKER_THREAD_ERR_CANCEL_BUSY             \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 34)
+
+/** \ref cy_worker_thread_cancel marked the work queued on the lanes, which the worker thread
+ * drops when it reaches it */
+#define CY_WORKER_THREAD_CANCEL_PENDING              \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_INFO, CY_RSLT_MODULE_ABSTRACTION_OS, 35)
+
 /** Worker thread function call prototype  */
 typedef void (cy_worker_thread_func_t)(void* arg);
 
+#if !defined(CY_WORKER_THREAD_STATS_BUCKETS)
+/** Number of buckets in the latency and run time histograms of
+ * \ref cy_worker_thread_stats_t. Bucket 0 counts durations below 1 ms and bucket n counts
+ * durations from 2^(n-1) up to 2^n ms. The last bucket also counts anything longer. */
+#define CY_WORKER_THREAD_STATS_BUCKETS              (8)
+#endif
+
+#if defined(DOXYGEN)
+/** Define to collect \ref cy_worker_thread_stats_t. Each queue entry then also holds the time
+ * the work was queued, which \ref cy_worker_pool_params_t::grow_latency_ms needs as well. */
+#define CY_WORKER_THREAD_ENABLE_STATS
+#endif
+
 /** Thread state enumeration */
 typedef enum
 {
     CY_WORKER_THREAD_INVALID,       /**< Worker Thread is in invalid state      */
     CY_WORKER_THREAD_VALID,         /**< Worker Thread is in valid state        */
-    CY_WORKER_THREAD_ENQUEUING,     /**< Worker Thread is adding to the queue   */
+    CY_WORKER_THREAD_ENQUEUING,     /**< Not used. Enqueue requests in progress are
+                                         counted in \ref cy_worker_thread_info_t::enqueue_count */
     CY_WORKER_THREAD_TERMINATING,   /**< Worker Thread is starting to terminate */
     CY_WORKER_THREAD_JOIN_COMPLETE  /**< Worker Thread join is complete         */
 } cy_worker_thread_state_t;
 
+/** Worker pool scheduling mode */
+typedef enum
+{
+    CY_WORKER_POOL_SHARED_QUEUE,    /**< All pool threads take work from one shared queue     */
+    CY_WORKER_POOL_WORK_STEALING    /**< Each pool thread owns a local deque and idle threads
+                                         steal work from the deques of busy threads            */
+} cy_worker_pool_mode_t;
+
+/** Action taken when work is queued on a worker whose queue is full */
+typedef enum
+{
+    CY_WORKER_THREAD_OVERFLOW_FAIL,        /**< The request fails and the work is not queued */
+    CY_WORKER_THREAD_OVERFLOW_BLOCK,       /**< Wait until there is room, up to the timeout
+                                                of \ref cy_worker_thread_enqueue_timeout and
+                                                without limit for the other enqueue functions.
+                                                The request fails with \ref CY_RTOS_TIMEOUT
+                                                once the wait has expired. From an ISR this
+                                                behaves like \ref CY_WORKER_THREAD_OVERFLOW_FAIL */
+    CY_WORKER_THREAD_OVERFLOW_DROP_OLDEST, /**< The oldest queued work is discarded to make
+                                                room for the new work */
+    CY_WORKER_THREAD_OVERFLOW_DROP_NEWEST  /**< The new work is discarded and the request
+                                                reports success */
+} cy_worker_thread_overflow_t;
+
+/** Work item that is embedded in a caller owned structure.
+ *
+ * Queueing an item links it into a list owned by the worker instead of copying it into the
+ * event queue, so the number of pending items is not limited by
+ * \ref cy_worker_thread_params_t::num_entries. An item can be pending only once; queueing an
+ * item that is already pending has no effect. The item must stay valid while it is pending and
+ * must be initialized with \ref cy_work_item_init.
+ */
+typedef struct cy_work_item
+{
+    struct cy_work_item*     next;           /**< Next pending item, owned by the worker */
+    cy_worker_thread_func_t* work_func;      /**< Function to run                    */
+    void*                    arg;            /**< Opaque arg passed to work_func     */
+    uint32_t                 pending;        /**< Non-zero while queued on a worker  */
+} cy_work_item_t;
+
+/** Periodic work that is embedded in a caller owned structure.
+ *
+ * Started with \ref cy_worker_thread_enqueue_periodic and stopped with
+ * \ref cy_worker_thread_stop_periodic. The structure must stay valid while the work is
+ * scheduled.
+ */
+typedef struct cy_worker_periodic
+{
+    struct cy_worker_periodic* next;      /**< Next scheduled work, owned by the worker */
+    cy_worker_thread_func_t*   work_func; /**< Function to run                        */
+    void*                      arg;       /**< Opaque arg passed to work_func         */
+    void*                      worker;    /**< Worker the work is scheduled on        */
+    cy_time_t                  period_ms; /**< Time between two runs                  */
+    cy_time_t                  due;       /**< When the work runs next                */
+    uint32_t                   state;     /**< Scheduling flags                       */
+    uint32_t                   overruns;  /**< Number of runs skipped because the work
+                                               ran a whole period late               */
+} cy_worker_periodic_t;
+
+/** Work queued on a worker thread. Internal use only. */
+typedef struct
+{
+    cy_worker_thread_func_t* work_func; /**< Function to run */
+    void*                    arg;       /**< Opaque arg passed to work_func */
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    cy_time_t                time;      /**< When the work was queued, or became due if
+                                             delayed */
+    #endif
+} cy_worker_dispatch_info_t;
+
+/** Work queued to run at a given time. Internal use only. */
+typedef struct
+{
+    cy_worker_dispatch_info_t dispatch_info; /**< Work to run */
+    cy_time_t                 time;          /**< When the work becomes due, or its deadline */
+} cy_worker_timed_info_t;
+
+#if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+/** Queued work cancelled with \ref cy_worker_thread_cancel that the worker thread has not
+ * dropped yet. Internal use only. */
+typedef struct
+{
+    cy_worker_thread_func_t* work_func; /**< Function of the cancelled work */
+    void*                    arg;       /**< Opaque arg of the cancelled work */
+    uint32_t                 epoch;     /**< Work queued up to this cancel epoch is dropped */
+    uint32_t                 lanes;     /**< Lanes that may still hold the work, 0 if unused */
+} cy_worker_tombstone_t;
+
+/** Bytes of a queue entry that hold the cancel epoch. Internal use only. */
+#define CY_WORKER_THREAD_EPOCH_SIZE                 (sizeof(uint32_t))
+#else
+#define CY_WORKER_THREAD_EPOCH_SIZE                 (0U)
+#endif
+
+/** Size of one queue entry of a worker whose \ref cy_worker_thread_params_t::payload_size is
+ * payload_size. Payloads are rounded up to whole 32-bit words. */
+#define CY_WORKER_THREAD_QUEUE_ENTRY_SIZE(payload_size)                                  \
+    (sizeof(cy_worker_dispatch_info_t) + CY_WORKER_THREAD_EPOCH_SIZE +                    \
+     (((payload_size) + 3U) & ~3U))
+
+/** Number of bytes of \ref cy_worker_thread_params_t::queue_storage needed per priority lane
+ * of a worker that queues num_entries entries of up to payload_size payload bytes per lane. */
+#define CY_WORKER_THREAD_PAYLOAD_QUEUE_STORAGE_SIZE(num_entries, payload_size)           \
+    ((CY_RTOS_QUEUE_STORAGE_SIZE((num_entries),                                           \
+                                 CY_WORKER_THREAD_QUEUE_ENTRY_SIZE(payload_size)) +       \
+      CY_RTOS_ALIGNMENT_MASK) & ~CY_RTOS_ALIGNMENT_MASK)
+
+/** Number of bytes of \ref cy_worker_thread_params_t::queue_storage needed per priority lane
+ * of a worker that queues num_entries entries per lane. */
+#define CY_WORKER_THREAD_QUEUE_STORAGE_SIZE(num_entries)                                 \
+    CY_WORKER_THREAD_PAYLOAD_QUEUE_STORAGE_SIZE(num_entries, 0)
+
 /** Worker Thread Parameters. */
 typedef struct
 {
@@ -82,18 +253,269 @@ typedef struct
                                             \ref CY_WORKER_THREAD_DEFAULT_NAME will be used. */
     uint32_t             num_entries;  /**< Maximum number of enteries the worker thread can queue.
                                             If set to 0, \ref CY_WORKER_DEFAULT_ENTRIES
-                                            will be used.       */
+                                            will be used. With priority lanes this is
+                                            the size of each lane. */
+    uint32_t             num_lanes;    /**< Number of priority lanes. Lane 0 is the
+                                            lowest priority and is used by
+                                            \ref cy_worker_thread_enqueue. If set to 0,
+                                            a single lane is used. Must not exceed
+                                            \ref CY_WORKER_THREAD_MAX_LANES. */
+    uint32_t             batch_size;   /**< Maximum number of work items taken from
+                                            lane 0 each time the worker wakes up and
+                                            then run back-to-back. If set to 0, one
+                                            item is taken per wakeup. Must not exceed
+                                            \ref CY_WORKER_THREAD_MAX_BATCH. In a pool
+                                            all items of a batch run on one thread. */
+    uint32_t             num_delayed;  /**< Maximum number of delayed work items that
+                                            can be pending at the same time. If set to
+                                            0, \ref cy_worker_thread_enqueue_delayed
+                                            only accepts a delay of 0. */
+    uint32_t             num_coalesce; /**< Maximum number of distinct function and
+                                            argument pairs that
+                                            \ref cy_worker_thread_enqueue_coalesced can
+                                            keep pending at the same time. If set to 0,
+                                            requests are never merged. */
+    cy_worker_thread_overflow_t overflow; /**< What happens when the queue of a lane is
+                                               still full once the enqueue timeout has
+                                               elapsed. Defaults to
+                                               \ref CY_WORKER_THREAD_OVERFLOW_FAIL. */
+    cy_thread_cb_t*      thread_cb;    /**< Control block of the thread. If not NULL the
+                                            worker is created without any heap
+                                            allocation: \ref stack, \ref queue_storage
+                                            and, when used, \ref delayed_storage,
+                                            \ref deadline_storage, \ref deferred_storage and
+                                            \ref coalesce_storage must be provided too.
+                                            If NULL, the storage fields are ignored.
+                                            Not supported for pools. */
+    void*                queue_storage; /**< Memory for the queues of all lanes, aligned to
+                                             \ref CY_RTOS_ALIGNMENT_MASK. Must hold
+                                             num_lanes times
+                                             \ref CY_WORKER_THREAD_QUEUE_STORAGE_SIZE bytes,
+                                             or
+                                             \ref CY_WORKER_THREAD_PAYLOAD_QUEUE_STORAGE_SIZE
+                                             bytes with a payload size. */
+    cy_worker_timed_info_t* delayed_storage; /**< Memory for \ref num_delayed entries */
+    cy_work_item_t*      coalesce_storage; /**< Memory for \ref num_coalesce items */
+    uint32_t             num_deadline; /**< Maximum number of work items with a deadline
+                                            that can be pending at the same time. If set
+                                            to 0, \ref cy_worker_thread_enqueue_deadline
+                                            is not available. */
+    cy_worker_timed_info_t* deadline_storage; /**< Memory for \ref num_deadline entries */
+    uint32_t             payload_size; /**< Maximum number of bytes that
+                                            \ref cy_worker_thread_enqueue_payload copies
+                                            into a queue entry. Every entry of every lane
+                                            grows by this much. If set to 0, work cannot
+                                            be queued with a payload. Must not exceed
+                                            \ref CY_WORKER_THREAD_MAX_PAYLOAD. */
+    uint32_t             num_deferred; /**< Maximum number of deferrable work items that
+                                            can be held at the same time. If set to 0,
+                                            \ref cy_worker_thread_enqueue_deferred
+                                            only accepts a slack of 0. */
+    cy_worker_timed_info_t* deferred_storage; /**< Memory for \ref num_deferred entries */
 } cy_worker_thread_params_t;
 
+/** Completion handle for work queued with \ref cy_worker_thread_enqueue_completion.
+ *
+ * The handle is owned by the caller, typically on its stack, and no RTOS object is created for
+ * it: a waiting thread is woken with a thread notification.
+ */
+typedef struct
+{
+    cy_worker_thread_func_t* work_func;      /**< Function to run                    */
+    void*                    arg;            /**< Opaque arg passed to work_func     */
+    cy_thread_t              waiter;         /**< Thread waiting for completion      */
+    uint32_t                 state;          /**< Completion and waiter flags        */
+} cy_worker_completion_t;
+
+/** Runtime statistics of a worker thread, collected if \ref CY_WORKER_THREAD_ENABLE_STATS is
+ * defined. Durations are measured with \ref cy_rtos_time_get and therefore have a resolution
+ * of one RTOS tick. */
+typedef struct
+{
+    uint32_t enqueued;       /**< Number of work items accepted for running       */
+    uint32_t dropped;        /**< Number of work items discarded by the overflow policy */
+    uint32_t coalesced;      /**< Number of requests merged into pending work     */
+    uint32_t cancelled;      /**< Number of work items removed by
+                                  \ref cy_worker_thread_cancel */
+    uint32_t missed;         /**< Number of work items that started after their
+                                  deadline                                      */
+    uint32_t completed;      /**< Number of work items that have run              */
+    uint32_t max_depth;      /**< Highest number of items seen on one queue       */
+    uint32_t latency[CY_WORKER_THREAD_STATS_BUCKETS];  /**< Histogram of the time from
+                                                            queueing (or expiry, for delayed
+                                                            work) to the start of running.
+                                                            Work items are not included. */
+    uint32_t run_time[CY_WORKER_THREAD_STATS_BUCKETS]; /**< Histogram of the time spent in
+                                                            the work function */
+} cy_worker_thread_stats_t;
+
 /** Worker Thread Information. */
 typedef struct
 {
     cy_queue_t               event_queue;    /**< Event Queue for this thread */
-    uint32_t                 enqueue_count;  /**< Number of conccurent enqueue requests */
+    uint32_t                 enqueue_count;  /**< Number of conccurent enqueue requests.
+                                                  Updated atomically; the top bit is set
+                                                  while the worker refuses new work. */
     cy_thread_t              thread;         /**< Thread object               */
     cy_worker_thread_state_t state;          /**< State of the worker thread  */
+    cy_queue_t               lane_queues[CY_WORKER_THREAD_MAX_LANES - 1]; /**< Queues for
+                                                                               lanes 1 and up */
+    uint32_t                 num_lanes;      /**< Number of priority lanes    */
+    uint32_t                 lane_pending;   /**< Work queued on lanes 1 and up */
+    uint32_t                 batch_size;     /**< Maximum work items taken per wakeup */
+    uint32_t                 batch_count;    /**< Number of wakeups that took work from
+                                                  lane 0. The effective batch size is
+                                                  batch_items / batch_count. */
+    uint32_t                 batch_items;    /**< Number of work items taken from lane 0 */
+    void*                    delayed;        /**< Delayed work ordered by expiry time */
+    uint32_t                 delayed_size;   /**< Capacity of the delayed work storage */
+    uint32_t                 delayed_count;  /**< Number of pending delayed work items */
+    void*                    deadline;       /**< Work with a deadline ordered by deadline */
+    uint32_t                 deadline_size;  /**< Capacity of the deadline work storage */
+    uint32_t                 deadline_count; /**< Number of pending work items with a
+                                                  deadline */
+    cy_work_item_t*          items;          /**< Pending work items, most recent first */
+    cy_work_item_t*          coalesce;       /**< Items used for coalesced requests */
+    uint32_t                 coalesce_size;  /**< Number of items in coalesce */
+    cy_worker_thread_overflow_t overflow;    /**< Action taken when a queue is full */
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    cy_worker_thread_stats_t stats;          /**< Runtime statistics, read them with
+                                                  \ref cy_worker_thread_get_stats */
+    #endif
+    uint32_t                 paused;         /**< Set while the worker is paused */
+    uint32_t                 parked;         /**< Non-zero once the worker has paused */
+    uint32_t                 flush_seq;      /**< Last flush requested           */
+    uint32_t                 flushed;        /**< Last flush completed           */
+    void*                    waiters;        /**< Threads waiting for a flush or pause */
+    bool                     static_mem;     /**< Storage was provided by the caller */
+    #if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+    uint32_t                 cancel_epoch;   /**< Incremented by every cancel of queued work */
+    cy_worker_tombstone_t    tombstones[CY_WORKER_THREAD_MAX_CANCEL]; /**< Queued work to drop */
+    #endif
+    void*                    pool;           /**< Elastic pool the worker belongs to,
+                                                  otherwise NULL */
+    uint32_t                 payload_size;   /**< Payload bytes per queue entry */
+    cy_worker_periodic_t*    periodic;       /**< Scheduled periodic work, earliest first */
+    void*                    deferred;       /**< Deferrable work ordered by latest start */
+    uint32_t                 deferred_size;  /**< Capacity of the deferrable work storage */
+    uint32_t                 deferred_count; /**< Number of held deferrable work items */
+    uint32_t                 flush_evicted;  /**< Last flush whose marker was displaced by
+                                                  \ref CY_WORKER_THREAD_OVERFLOW_DROP_OLDEST */
+    cy_thread_t              stopper;        /**< Thread waiting in delete for running enqueue
+                                                  requests to finish */
+    bool                     pooled;         /**< Worker is \ref cy_worker_pool_t::worker */
+    bool                     stealing;       /**< Worker of a work-stealing pool, which has
+                                                  no event queue */
 } cy_worker_thread_info_t;
 
+/** Worker Pool Parameters. */
+typedef struct
+{
+    cy_worker_thread_params_t thread_params; /**< Parameters applied to every thread in the pool.
+                                                  If \ref cy_worker_thread_params_t::stack is not
+                                                  NULL it must be large enough to hold
+                                                  max_threads (or num_threads) stacks of
+                                                  \ref cy_worker_thread_params_t::stack_size
+                                                  bytes each. */
+    uint32_t                  num_threads;   /**< Number of threads sharing the queue. If set
+                                                  to 0, \ref CY_WORKER_POOL_DEFAULT_THREADS will be
+                                                  used. Must not exceed
+                                                  \ref CY_WORKER_POOL_MAX_THREADS. For an
+                                                  elastic pool this is the minimum. */
+    cy_worker_pool_mode_t     mode;          /**< How work is distributed between the threads.
+                                                  For \ref CY_WORKER_POOL_WORK_STEALING,
+                                                  \ref cy_worker_thread_params_t::num_entries is
+                                                  the capacity of each local deque and
+                                                  priority lanes are not supported. */
+    uint32_t                  max_threads;   /**< If greater than num_threads the pool is
+                                                  elastic: threads are added while work
+                                                  backs up and retire again once idle. Must
+                                                  not exceed \ref CY_WORKER_POOL_MAX_THREADS.
+                                                  Only supported for
+                                                  \ref CY_WORKER_POOL_SHARED_QUEUE. */
+    uint32_t                  grow_backlog;  /**< Elastic pools: a thread is added when a pool
+                                                  thread takes work while at least this many
+                                                  items are still queued. If both this and
+                                                  grow_latency_ms are 0, any backlog adds a
+                                                  thread. */
+    cy_time_t                 grow_latency_ms; /**< Elastic pools: a thread is added when work
+                                                    waited at least this long before a pool
+                                                    thread took it. 0 disables the check.
+                                                    Requires
+                                                    \ref CY_WORKER_THREAD_ENABLE_STATS. */
+    cy_time_t                 idle_timeout_ms; /**< Elastic pools: a thread above num_threads
+                                                    retires after waiting this long without
+                                                    work. If set to 0,
+                                                    \ref CY_WORKER_POOL_DEFAULT_IDLE_MS will
+                                                    be used. */
+} cy_worker_pool_params_t;
+
+/** Local work deque owned by one thread of a \ref CY_WORKER_POOL_WORK_STEALING pool. */
+typedef struct
+{
+    void*    pool;     /**< Pool that owns this deque          */
+    void*    entries;  /**< Ring storage for the queued work   */
+    uint32_t size;     /**< Capacity of the deque              */
+    uint32_t head;     /**< Index of the oldest queued work    */
+    uint32_t count;    /**< Number of queued work items        */
+    uint32_t idle;     /**< Owning thread is waiting for work  */
+    uint32_t lock;     /**< Held while the deque is updated    */
+} cy_worker_deque_t;
+
+/** Worker Pool Information. */
+typedef struct
+{
+    cy_worker_thread_info_t worker;                              /**< Shared event queue and
+                                                                      state of the pool */
+    cy_thread_t             threads[CY_WORKER_POOL_MAX_THREADS]; /**< Thread objects      */
+    uint32_t                num_threads;                         /**< Number of threads   */
+    cy_worker_pool_mode_t   mode;                                /**< Scheduling mode     */
+    cy_worker_deque_t       deques[CY_WORKER_POOL_MAX_THREADS];  /**< Per-thread deques,
+                                                                      work-stealing only  */
+    uint32_t                next_deque;                          /**< Next deque to receive
+                                                                      work from outside
+                                                                      the pool            */
+    cy_worker_pool_params_t params;                              /**< Creation parameters,
+                                                                      used to add threads */
+    uint32_t                live;                                /**< Slots of threads that
+                                                                      take work           */
+    uint32_t                retired;                             /**< Slots of retired
+                                                                      threads not joined
+                                                                      yet                 */
+    uint32_t                resizing;                            /**< Set while a thread is
+                                                                      added or joined     */
+} cy_worker_pool_t;
+
+/** Stage of a \ref cy_worker_graph_t. Owned by the caller and added with
+ * \ref cy_worker_graph_add_stage; it must stay valid as long as the graph is used. */
+typedef struct cy_worker_stage
+{
+    cy_work_item_t           item;             /**< Queues the stage when the queue is full */
+    cy_worker_thread_func_t* work_func;        /**< Function to run                         */
+    void*                    arg;              /**< Opaque arg passed to work_func          */
+    void*                    graph;            /**< Graph the stage belongs to              */
+    struct cy_worker_stage*  next;             /**< Next stage of the graph                 */
+    struct cy_worker_stage*  successors[CY_WORKER_GRAPH_MAX_SUCCESSORS]; /**< Stages that
+                                                                              depend on this
+                                                                              one */
+    uint32_t                 num_successors;   /**< Number of entries in successors         */
+    uint32_t                 num_predecessors; /**< Number of stages this one depends on    */
+    uint32_t                 remaining;        /**< Predecessors that have not finished in
+                                                    the current run                         */
+} cy_worker_stage_t;
+
+/** Graph of stages that run on a worker thread or pool once their dependencies finish. */
+typedef struct
+{
+    cy_worker_thread_info_t* worker;     /**< Worker that runs the stages              */
+    cy_worker_stage_t*       stages;     /**< Stages, most recently added first        */
+    uint32_t                 num_stages; /**< Number of stages                         */
+    uint32_t                 remaining;  /**< Stages that have not finished in the
+                                              current run                              */
+    cy_worker_completion_t   done;       /**< Marked done when a run has finished      */
+    cy_rslt_t                result;     /**< First error of the current run           */
+} cy_worker_graph_t;
+
 /** Create worker thread to handle running callbacks in a separate thread.
  *
  * @note Calling this function twice on the same thread object ( \ref cy_worker_thread_info_t)
@@ -111,7 +533,8 @@ cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
 /** Delete worker thread.
  *
  * @note This function will wait for the thread to complete all pending work in the
- * queue and exit before returning.
+ * queue and exit before returning. A paused worker is resumed. The calling thread may be left
+ * with a pending thread notification.
  *
  * @param[in] old_worker    pointer to cy_worker_thread_info_t structure to be deleted.
  *
@@ -121,7 +544,9 @@ cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker);
 
 /** Queue work on a worker thread.
  *
- * Call the given function in the worker thread context.
+ * Call the given function in the worker thread context. If the queue is full, the overflow
+ * policy from \ref cy_worker_thread_params_t::overflow is applied without waiting, except that
+ * \ref CY_WORKER_THREAD_OVERFLOW_BLOCK waits until there is room.
  *
  * @note If the thread priority is below that of the current thread, you must yield to allow
  * the worker thread to run. This can be done by calling \ref cy_rtos_delay_milliseconds or
@@ -136,6 +561,545 @@ cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker);
 cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
                                    cy_worker_thread_func_t* work_func, void* arg);
 
+/** Queue work on a worker thread, waiting for room in the queue.
+ *
+ * Same as \ref cy_worker_thread_enqueue, but if the queue is full the caller waits up to
+ * timeout_ms for the worker to make room. If the queue is still full after that, the overflow
+ * policy from \ref cy_worker_thread_params_t::overflow is applied; under
+ * \ref CY_WORKER_THREAD_OVERFLOW_BLOCK the request then fails with \ref CY_RTOS_TIMEOUT. This
+ * lets producers on thread context apply backpressure instead of retrying in a loop.
+ *
+ * @note From an ISR the timeout is ignored and treated as 0.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ * @param[in] timeout_ms     maximum time to wait for room in the queue
+ *
+ * @return The status of the queueing of work.
+ */
+cy_rslt_t cy_worker_thread_enqueue_timeout(cy_worker_thread_info_t* worker_info,
+                                           cy_worker_thread_func_t* work_func, void* arg,
+                                           cy_time_t timeout_ms);
+
+/** Queue work on a priority lane of a worker thread.
+ *
+ * Call the given function in the worker thread context. Before running the next piece of
+ * work the worker always takes it from the highest priority lane that has work queued, so
+ * work on a higher lane is never delayed by work queued earlier on a lower lane. Work queued
+ * on the same lane runs in FIFO order.
+ *
+ * @note A callback that is already running is not preempted by work queued on a higher lane.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ * @param[in] priority       lane to queue the work on. 0 is the lowest priority and is the
+ *                           lane used by \ref cy_worker_thread_enqueue. Must be less than
+ *                           \ref cy_worker_thread_params_t::num_lanes.
+ *
+ * @return The status of the queueing of work.
+ */
+cy_rslt_t cy_worker_thread_enqueue_prio(cy_worker_thread_info_t* worker_info,
+                                        cy_worker_thread_func_t* work_func, void* arg,
+                                        uint32_t priority);
+
+/** Queue work on a worker thread to be run after a delay.
+ *
+ * Call the given function in the worker thread context once delay_ms milliseconds have
+ * elapsed. All pending delayed work of a worker is kept in one list ordered by expiry time,
+ * so no RTOS timer is needed per item; the worker simply bounds its wait for new work by the
+ * earliest expiry time.
+ *
+ * Expired delayed work runs before work queued on lane 0 but after work queued on higher
+ * priority lanes. The delay is a minimum; the work may run later if the worker is busy.
+ *
+ * @note Delayed work that has not expired when \ref cy_worker_thread_delete is called is
+ * discarded.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ * @param[in] delay_ms       minimum time to wait before running the function. If 0, this is
+ *                           the same as \ref cy_worker_thread_enqueue.
+ *
+ * @return The status of the queueing of work. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_QUEUE_FULL,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_worker_thread_enqueue_delayed(cy_worker_thread_info_t* worker_info,
+                                           cy_worker_thread_func_t* work_func, void* arg,
+                                           cy_time_t delay_ms);
+
+/** Run work on a worker thread at a fixed period.
+ *
+ * Call the given function in the worker thread context every period_ms milliseconds, the
+ * first time one period after this call. The times are absolute: each run is due exactly one
+ * period after the previous one was due, so the schedule does not drift by the time the worker
+ * takes to get to the work. If a run starts so late that one or more later runs are already
+ * due, those are skipped and counted in \ref cy_worker_periodic_t::overruns.
+ *
+ * Unlike \ref cy_rtos_timer_t callbacks, which all share the timer service task of the RTOS,
+ * periodic work only competes with other work of the same worker. Scheduled periodic work is
+ * kept in a list owned by the worker, so it takes no queue entries and is not limited by
+ * \ref cy_worker_thread_params_t::num_delayed. Due periodic work runs along with expired
+ * delayed work, before work queued on lane 0.
+ *
+ * @note Periodic work that is scheduled when \ref cy_worker_thread_delete is called is
+ * discarded.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[out] periodic      caller owned handle of the periodic work
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ * @param[in] period_ms      time between two runs. Must not be 0.
+ *
+ * @return The status of the request. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_BAD_PARAM if the handle
+ *         is already scheduled or the worker has no event queue]
+ */
+cy_rslt_t cy_worker_thread_enqueue_periodic(cy_worker_thread_info_t* worker_info,
+                                            cy_worker_periodic_t* periodic,
+                                            cy_worker_thread_func_t* work_func, void* arg,
+                                            cy_time_t period_ms);
+
+/** Stop periodic work.
+ *
+ * The work is not run again. If it is running when this is called, that run completes, and on
+ * a worker with a single thread \ref cy_worker_thread_flush can be used to wait for it
+ * before the handle is released. The function can also be called from the work function
+ * itself.
+ *
+ * This function can be called from an ISR.
+ *
+ * @param[in] worker_info    pointer to worker_thread the work was scheduled on. The work is
+ *                           always removed from the worker recorded in the handle.
+ * @param[in] periodic       handle passed to \ref cy_worker_thread_enqueue_periodic
+ */
+void cy_worker_thread_stop_periodic(cy_worker_thread_info_t* worker_info,
+                                    cy_worker_periodic_t* periodic);
+
+/** Queue work on a worker thread that may be deferred for up to slack_ms milliseconds.
+ *
+ * Deferrable work does not wake the worker by itself. The worker holds it (up to
+ * \ref cy_worker_thread_params_t::num_deferred items) and runs everything it holds the next
+ * time it is awake anyway: when other work arrives, when a flush is requested, or at the
+ * latest when the slack of the oldest held work runs out. Housekeeping queued this way is
+ * gathered into a few wakeups, and since the worker simply blocks with a timeout the RTOS
+ * can stay in tickless (deep) sleep until then.
+ *
+ * Held work is run before the worker terminates.
+ *
+ * This function can be called from an ISR.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ * @param[in] slack_ms       maximum time the work may be held. If 0, this is the same as
+ *                           \ref cy_worker_thread_enqueue.
+ *
+ * @return The status of the queueing of work. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_QUEUE_FULL,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_worker_thread_enqueue_deferred(cy_worker_thread_info_t* worker_info,
+                                            cy_worker_thread_func_t* work_func, void* arg,
+                                            cy_time_t slack_ms);
+
+/** Queue work on a worker thread to be run by a deadline.
+ *
+ * Call the given function in the worker thread context, earliest deadline first. Pending work
+ * with a deadline is kept in one list ordered by deadline (up to
+ * \ref cy_worker_thread_params_t::num_deadline items), and the worker always takes the work
+ * with the earliest deadline next. This lets time critical callbacks share a worker with bulk
+ * work queued with \ref cy_worker_thread_enqueue without waiting behind it.
+ *
+ * Work with a deadline runs before work queued on lane 0 but after work queued on higher
+ * priority lanes and expired delayed work. Work that is already running is not preempted, so
+ * the deadline is met only if the work ahead of it is short enough. Work that starts after its
+ * deadline still runs and is counted in \ref cy_worker_thread_stats_t::missed.
+ *
+ * This function can be called from an ISR.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ * @param[in] deadline       absolute time, as returned by \ref cy_rtos_time_get, by which the
+ *                           function should start. Must be less than 2^31 ms away.
+ *
+ * @return The status of the queueing of work. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_QUEUE_FULL,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_worker_thread_enqueue_deadline(cy_worker_thread_info_t* worker_info,
+                                            cy_worker_thread_func_t* work_func, void* arg,
+                                            cy_time_t deadline);
+
+/** Queue work on a worker thread together with a copy of a small payload.
+ *
+ * The payload is copied into the queue entry, so data such as a few bytes read in an
+ * interrupt handler can be passed to the worker without allocating or reserving a buffer for
+ * it. work_func is called with a pointer to a copy of the payload, aligned to 4 bytes, that is
+ * valid until work_func returns. The work is queued on lane 0 and the overflow policy of the
+ * worker applies, as for \ref cy_worker_thread_enqueue.
+ *
+ * Work queued with a payload has no arg to match, so \ref cy_worker_thread_cancel returns
+ * \ref CY_RTOS_UNSUPPORTED for a worker created with a payload size.
+ *
+ * This function can be called from an ISR.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] payload        data to copy
+ * @param[in] size           number of bytes to copy. Must not exceed
+ *                           \ref cy_worker_thread_params_t::payload_size.
+ *
+ * @return The status of the queueing of work. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_QUEUE_FULL,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_worker_thread_enqueue_payload(cy_worker_thread_info_t* worker_info,
+                                           cy_worker_thread_func_t* work_func,
+                                           const void* payload, size_t size);
+
+/** Initialize a work item.
+ *
+ * Must be called before the item is first queued and not while it is pending.
+ *
+ * @param[out] item          item to initialize
+ * @param[in]  work_func     function the worker thread calls when the item runs
+ * @param[in]  arg           opaque arg to be used in function call
+ */
+void cy_work_item_init(cy_work_item_t* item, cy_worker_thread_func_t* work_func, void* arg);
+
+/** Queue a work item on a worker thread.
+ *
+ * Link the item into the worker's pending list. Pending items run in the order they were
+ * queued, at the same priority as work queued with \ref cy_worker_thread_enqueue. The item is
+ * no longer pending when its function is called, so the function may queue the item again.
+ * Pending items are run before the worker thread terminates.
+ *
+ * This function can be called from an ISR.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run the item
+ * @param[in] item           item initialized with \ref cy_work_item_init
+ *
+ * @return The status of the queueing of work. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_BAD_PARAM]. Queueing an item
+ *         that is already pending is reported as \ref CY_RSLT_SUCCESS.
+ */
+cy_rslt_t cy_worker_thread_enqueue_item(cy_worker_thread_info_t* worker_info,
+                                        cy_work_item_t* item);
+
+/** Queue work on a worker thread, merging it with an identical pending request.
+ *
+ * If the same work_func and arg pair is already queued with this function and has not
+ * started running, the request is merged into the pending one and the function runs only
+ * once. This suits notifications such as "data available" that are raised many times before
+ * the worker gets to them. A request made while the function is running queues it again.
+ *
+ * Pending pairs are tracked in \ref cy_worker_thread_params_t::num_coalesce work items.
+ * When all of them are in use the request is queued as by \ref cy_worker_thread_enqueue.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ *
+ * @return The status of the queueing of work. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_QUEUE_FULL,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_worker_thread_enqueue_coalesced(cy_worker_thread_info_t* worker_info,
+                                             cy_worker_thread_func_t* work_func, void* arg);
+
+/** Queue work on a worker thread and get a handle to wait for it to finish.
+ *
+ * Same as \ref cy_worker_thread_enqueue, but the completion handle can be passed to
+ * \ref cy_worker_completion_wait to block until work_func has returned.
+ *
+ * @note The handle must stay valid until the work has run, even if a wait on it timed out.
+ * Work discarded by the overflow policy never completes.
+ *
+ * @param[in]  worker_info   pointer to worker_thread used to run function
+ * @param[in]  work_func     function to run
+ * @param[in]  arg           opaque arg to be used in function call
+ * @param[out] completion    handle to initialize for the queued work
+ *
+ * @return The status of the queueing of work.
+ */
+cy_rslt_t cy_worker_thread_enqueue_completion(cy_worker_thread_info_t* worker_info,
+                                              cy_worker_thread_func_t* work_func, void* arg,
+                                              cy_worker_completion_t* completion);
+
+/** Wait for work queued with \ref cy_worker_thread_enqueue_completion to finish.
+ *
+ * Only one thread may wait on a handle at a time. This function must not be called from an
+ * ISR or from the worker thread that runs the work.
+ *
+ * @note If the wait times out just as the work finishes, the calling thread may be left with
+ * a pending thread notification.
+ *
+ * @param[in] completion     handle of the queued work
+ * @param[in] timeout_ms     maximum time to wait, or \ref CY_RTOS_NEVER_TIMEOUT
+ *
+ * @return The status of the wait. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_TIMEOUT]
+ */
+cy_rslt_t cy_worker_completion_wait(cy_worker_completion_t* completion, cy_time_t timeout_ms);
+
+/** Check whether work queued with \ref cy_worker_thread_enqueue_completion has finished.
+ *
+ * @param[in] completion     handle of the queued work
+ *
+ * @return true if work_func has returned
+ */
+bool cy_worker_completion_is_done(const cy_worker_completion_t* completion);
+
+/** Cancel work that is queued on a worker thread but has not started yet.
+ *
+ * Every pending request to call work_func with arg is removed: work on any lane, delayed
+ * and deferrable work, work with a deadline and work items, including coalesced requests.
+ * Cancelled work items are no longer pending and can be queued again. Work that the worker
+ * has already taken, for example as part of a batch, still runs. Work queued while this
+ * function runs may or may not be cancelled.
+ *
+ * Work on the lanes cannot be searched without taking it off the queues, so it is left in
+ * place: a tombstone records the request, and the worker drops matching work queued before
+ * this call when it reaches it and counts it in \ref cy_worker_thread_stats_t::cancelled then.
+ * Work can be queued from any context meanwhile. This function returns
+ * \ref CY_WORKER_THREAD_CANCEL_PENDING in that case; the work may still be queued, so wait
+ * with \ref cy_worker_thread_flush before releasing anything arg refers to. If work is queued
+ * on the lanes and all \ref CY_WORKER_THREAD_MAX_CANCEL tombstones are in use, nothing is
+ * cancelled and \ref CY_WORKER_THREAD_ERR_CANCEL_BUSY is returned without waiting. The worker
+ * frees a tombstone once it has passed the work queued before it.
+ *
+ * This function must not be called from an ISR. It can be called from the worker thread and
+ * while the worker is paused.
+ *
+ * @param[in] worker_info    pointer to worker_thread the work was queued on
+ * @param[in] work_func      function of the work to cancel
+ * @param[in] arg            opaque arg of the work to cancel
+ *
+ * @return The status of the cancel. [\ref CY_RSLT_SUCCESS if matching work was removed and
+ *         none is queued on the lanes, \ref CY_WORKER_THREAD_CANCEL_PENDING,
+ *         \ref CY_WORKER_THREAD_ERR_NOT_FOUND, \ref CY_WORKER_THREAD_ERR_CANCEL_BUSY,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_BAD_PARAM for
+ *         \ref cy_worker_pool_t::worker, \ref CY_RTOS_UNSUPPORTED if the worker was created
+ *         with a \ref cy_worker_thread_params_t::payload_size]
+ */
+cy_rslt_t cy_worker_thread_cancel(cy_worker_thread_info_t* worker_info,
+                                  cy_worker_thread_func_t* work_func, void* arg);
+
+/** Wait for all work queued on a worker thread before this call to finish.
+ *
+ * Unlike \ref cy_worker_thread_delete, the worker keeps running afterwards. This covers work
+ * on every lane, work with a deadline, deferrable work, work items and expired delayed work,
+ * but not delayed work that has not expired yet.
+ *
+ * @note A paused worker does not make progress, so a flush of a paused worker times out.
+ * This function must not be called from an ISR or from the worker thread itself. Pools are
+ * not supported: a pool thread taking the flush request does not know whether the other pool
+ * threads have finished the work they took before it.
+ *
+ * @param[in] worker_info    pointer to worker_thread to flush
+ * @param[in] timeout_ms     maximum time to wait, or \ref CY_RTOS_NEVER_TIMEOUT
+ *
+ * @return The status of the flush. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_TIMEOUT,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_BAD_PARAM for
+ *         \ref cy_worker_pool_t::worker]
+ */
+cy_rslt_t cy_worker_thread_flush(cy_worker_thread_info_t* worker_info, cy_time_t timeout_ms);
+
+/** Pause a worker thread.
+ *
+ * The worker stops taking new work; work can still be queued and runs once the worker is
+ * resumed with \ref cy_worker_thread_resume. Together with \ref cy_worker_thread_flush this
+ * quiesces deferred work, for example before entering deep sleep, without deleting the
+ * worker. This function waits for work that is already running to return.
+ *
+ * @note If the wait times out the worker still pauses as soon as the running work returns.
+ * This function must not be called from an ISR. Pausing is only supported for workers
+ * created with \ref cy_worker_thread_create.
+ *
+ * @param[in] worker_info    pointer to worker_thread to pause
+ * @param[in] timeout_ms     maximum time to wait for the worker to pause
+ *
+ * @return The status of the pause. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_TIMEOUT,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_BAD_PARAM for
+ *         \ref cy_worker_pool_t::worker]
+ */
+cy_rslt_t cy_worker_thread_pause(cy_worker_thread_info_t* worker_info, cy_time_t timeout_ms);
+
+/** Resume a worker thread paused with \ref cy_worker_thread_pause.
+ *
+ * @param[in] worker_info    pointer to worker_thread to resume
+ *
+ * @return The status of the resume.
+ */
+cy_rslt_t cy_worker_thread_resume(cy_worker_thread_info_t* worker_info);
+
+/** Get the runtime statistics of a worker thread.
+ *
+ * The counters and histograms accumulate from the creation of the worker. For a pool in
+ * \ref CY_WORKER_POOL_SHARED_QUEUE mode, pass \ref cy_worker_pool_t::worker to get the
+ * statistics of all pool threads combined. Pools in \ref CY_WORKER_POOL_WORK_STEALING mode
+ * do not collect statistics.
+ *
+ * @param[in]  worker_info   pointer to worker_thread to query
+ * @param[out] stats         receives a copy of the statistics
+ *
+ * @return The status of the query. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_UNSUPPORTED if
+ *         \ref CY_WORKER_THREAD_ENABLE_STATS is not defined]
+ */
+cy_rslt_t cy_worker_thread_get_stats(cy_worker_thread_info_t* worker_info,
+                                     cy_worker_thread_stats_t* stats);
+
+/** Create a pool of worker threads that share a single event queue.
+ *
+ * Work queued to the pool is run by whichever pool thread becomes available first, so a
+ * callback that blocks does not prevent other queued work from being run. There is no
+ * ordering guarantee between work items that run on different pool threads.
+ *
+ * In \ref CY_WORKER_POOL_WORK_STEALING mode the threads do not contend on a single queue.
+ * Work queued from a pool thread goes to that thread's own deque, and work queued from
+ * anywhere else is spread across the deques. A thread that runs out of work takes the most
+ * recently queued work from another thread's deque before going to sleep. Each deque has its
+ * own lock, held for a few instructions. \ref cy_worker_pool_t::worker has no event queue in
+ * this mode, so the cy_worker_thread functions return \ref CY_RTOS_BAD_PARAM for it.
+ *
+ * A \ref CY_WORKER_POOL_SHARED_QUEUE pool whose \ref cy_worker_pool_params_t::max_threads is
+ * greater than \ref cy_worker_pool_params_t::num_threads starts with the minimum number of
+ * threads. A pool thread that takes work while the backlog or queueing latency is above the
+ * configured threshold starts one more thread with \ref cy_rtos_thread_create, up to the
+ * maximum. A thread above the minimum that stays idle for
+ * \ref cy_worker_pool_params_t::idle_timeout_ms exits and is joined by one of the remaining
+ * threads, which releases its stack and control block.
+ *
+ * @note Calling this function twice on the same pool object ( \ref cy_worker_pool_t) without
+ * calling \ref cy_worker_pool_delete will cause memory leakage.
+ *
+ * @param[out] new_pool     pointer to cy_worker_pool_t structure to be filled when created.
+ * @param[in]  params       pointer to requested parameters for starting the pool threads.
+ *
+ * @return The status of the worker pool creation request.
+ */
+cy_rslt_t cy_worker_pool_create(cy_worker_pool_t* new_pool, const cy_worker_pool_params_t* params);
+
+/** Delete a pool of worker threads.
+ *
+ * @note This function will wait for the pool threads to complete all pending work in the
+ * queue and exit before returning.
+ *
+ * @param[in] old_pool      pointer to cy_worker_pool_t structure to be deleted.
+ *
+ * @return The status of the deletion of the worker pool.
+ */
+cy_rslt_t cy_worker_pool_delete(cy_worker_pool_t* old_pool);
+
+/** Queue work on a worker pool.
+ *
+ * Call the given function in the context of the first available pool thread.
+ *
+ * @param[in] pool           pointer to worker pool used to run function
+ * @param[in] work_func      function to run
+ * @param[in] arg            opaque arg to be used in function call
+ *
+ * @return The status of the queueing of work.
+ */
+cy_rslt_t cy_worker_pool_enqueue(cy_worker_pool_t* pool, cy_worker_thread_func_t* work_func,
+                                 void* arg);
+
+/** Initialize an empty stage graph.
+ *
+ * A graph is declared once with \ref cy_worker_graph_add_stage and
+ * \ref cy_worker_graph_add_dependency and can then be run any number of times. During a run,
+ * each stage is queued on the worker as soon as all the stages it depends on have finished,
+ * so stages that do not depend on each other run in parallel when the worker is
+ * \ref cy_worker_pool_t::worker of a \ref CY_WORKER_POOL_SHARED_QUEUE pool. Nothing is
+ * allocated; the graph and its stages are owned by the caller.
+ *
+ * A stage is queued with \ref cy_worker_thread_enqueue and, if the queue is full, as a work
+ * item instead, so a run never loses a stage. The worker must therefore use
+ * \ref CY_WORKER_THREAD_OVERFLOW_FAIL; the other policies would drop stages or hold up the
+ * run.
+ *
+ * @param[out] graph         graph to initialize
+ * @param[in]  worker_info   worker that runs the stages
+ *
+ * @return The status of the initialization. [\ref CY_RSLT_SUCCESS,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID, \ref CY_RTOS_BAD_PARAM if the worker
+ *         does not use \ref CY_WORKER_THREAD_OVERFLOW_FAIL or has no event queue]
+ */
+cy_rslt_t cy_worker_graph_init(cy_worker_graph_t* graph, cy_worker_thread_info_t* worker_info);
+
+/** Add a stage to a graph.
+ *
+ * Must not be called while the graph is running.
+ *
+ * @param[in]  graph         graph to add the stage to
+ * @param[out] stage         stage to initialize and add
+ * @param[in]  work_func     function the stage runs
+ * @param[in]  arg           opaque arg to be used in function call
+ */
+void cy_worker_graph_add_stage(cy_worker_graph_t* graph, cy_worker_stage_t* stage,
+                               cy_worker_thread_func_t* work_func, void* arg);
+
+/** Make a stage depend on another stage of the same graph.
+ *
+ * The stage runs only after predecessor has finished. A dependency that would form a cycle
+ * is refused. Must not be called while the graph is running.
+ *
+ * @param[in] stage          stage that depends on predecessor
+ * @param[in] predecessor    stage that has to finish first
+ *
+ * @return The status of the request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM if the
+ *         stages are in different graphs, predecessor already depends on stage or already
+ *         has \ref CY_WORKER_GRAPH_MAX_SUCCESSORS successors]
+ */
+cy_rslt_t cy_worker_graph_add_dependency(cy_worker_stage_t* stage,
+                                         cy_worker_stage_t* predecessor);
+
+/** Start a run of a graph.
+ *
+ * Queues the stages that do not depend on any other stage and returns. Use
+ * \ref cy_worker_graph_wait or \ref cy_worker_graph_is_done to find out when all stages
+ * have finished.
+ *
+ * If a stage cannot be queued, for example because the worker was deleted, the run fails:
+ * stages that have not started are skipped, and the run is done once the stages already
+ * running have finished. \ref cy_worker_graph_wait then returns the error.
+ *
+ * @param[in] graph          graph to run
+ *
+ * @return The status of the request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM if the
+ *         graph is still running or was not initialized,
+ *         \ref CY_WORKER_THREAD_ERR_THREAD_INVALID]
+ */
+cy_rslt_t cy_worker_graph_run(cy_worker_graph_t* graph);
+
+/** Wait for the current run of a graph to finish.
+ *
+ * Only one thread can wait for a run. This function must not be called from an ISR or from
+ * the worker running the graph.
+ *
+ * @param[in] graph          graph to wait for
+ * @param[in] timeout_ms     maximum time to wait, or \ref CY_RTOS_NEVER_TIMEOUT
+ *
+ * @return The status of the wait. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_TIMEOUT, or the
+ *         error that made the run fail]
+ */
+cy_rslt_t cy_worker_graph_wait(cy_worker_graph_t* graph, cy_time_t timeout_ms);
+
+/** Check whether a graph is idle.
+ *
+ * This function can be called from an ISR.
+ *
+ * @param[in] graph          graph to check
+ *
+ * @return true if every stage of the last run has finished, or the graph never ran
+ */
+bool cy_worker_graph_is_done(const cy_worker_graph_t* graph);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -44,6 +44,14 @@
  * APIs for acquiring and working with Mutexes.
  * \defgroup group_abstraction_rtos_queue Queue
  * APIs for creating and working with Queues.
+ * \defgroup group_abstraction_rtos_slot_queue Slot Queue
+ * APIs for creating and working with Queues whose items are built and consumed in place.
+ * \defgroup group_abstraction_rtos_ring Ring
+ * APIs for creating and working with single producer, single consumer rings.
+ * \defgroup group_abstraction_rtos_mpmc_queue MPMC Queue
+ * APIs for creating and working with lock-free multiple producer, multiple consumer queues.
+ * \defgroup group_abstraction_rtos_stream_buffer Stream and Message Buffers
+ * APIs for creating and working with buffers of bytes and of variable length messages.
  * \defgroup group_abstraction_rtos_semaphore Semaphore
  * APIs for acquiring and working with Semaphores.
  * \defgroup group_abstraction_rtos_threads Threads
@@ -221,6 +229,31 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
                                 const char* name, void* stack, uint32_t stack_size,
                                 cy_thread_priority_t priority, cy_thread_arg_t arg);
 
+/** Create a thread without allocating any memory.
+ *
+ * Same as \ref cy_rtos_thread_create, but the caller provides both the stack and the control
+ * block of the thread, so no memory is taken from the heap. Both must stay valid until
+ * \ref cy_rtos_thread_join has returned for the thread; they are not released by the RTOS.
+ *
+ * @param[out] thread         Pointer to a variable which will receive the new thread handle
+ * @param[in]  entry_function Function pointer which points to the main function for the new thread
+ * @param[in]  name           String thread name used for a debugger
+ * @param[in]  stack          The buffer to use for the thread stack. This must be aligned to
+ *                            \ref CY_RTOS_ALIGNMENT_MASK with a size of at least \ref
+ *                            CY_RTOS_MIN_STACK_SIZE. Must not be NULL.
+ * @param[in]  stack_size     The size of the thread stack in bytes
+ * @param[in]  priority       The priority of the thread
+ * @param[in]  arg            The argument to pass to the new thread
+ * @param[in]  cb             Memory for the thread control block
+ *
+ * @return The status of thread create request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM,
+ *         \ref CY_RTOS_ALIGNMENT_ERROR, \ref CY_RTOS_GENERAL_ERROR]
+ */
+cy_rslt_t cy_rtos_thread_create_static(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
+                                       const char* name, void* stack, uint32_t stack_size,
+                                       cy_thread_priority_t priority, cy_thread_arg_t arg,
+                                       cy_thread_cb_t* cb);
+
 /** Exit the current thread.
  *
  * This function is called just before a thread exits.  In some cases it is sufficient
@@ -633,6 +666,24 @@ cy_rslt_t cy_rtos_event_deinit(cy_event_t* event);
  */
 cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize);
 
+/** Create a queue without allocating any memory.
+ *
+ * Same as \ref cy_rtos_queue_init, but the caller provides the memory for the queue, so no
+ * memory is taken from the heap. The memory must stay valid until \ref cy_rtos_queue_deinit has
+ * returned for the queue; it is not released by the RTOS.
+ *
+ * @param[out] queue    Pointer to the queue handle
+ * @param[in]  length   The maximum length of the queue in items
+ * @param[in]  itemsize The size of each item in the queue.
+ * @param[in]  storage  Memory for the queue. This must be aligned to \ref CY_RTOS_ALIGNMENT_MASK
+ *                      and hold at least \ref CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize) bytes.
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM, \ref
+ *         CY_RTOS_ALIGNMENT_ERROR, \ref CY_RTOS_GENERAL_ERROR]
+ */
+cy_rslt_t cy_rtos_queue_init_static(cy_queue_t* queue, size_t length, size_t itemsize,
+                                    void* storage);
+
 /** Put an item in a queue.
  *
  * This function puts an item in the queue. The item is copied
@@ -667,6 +718,56 @@ cy_rslt_t cy_rtos_queue_put(cy_queue_t* queue, const void* item_ptr, cy_time_t t
  */
 cy_rslt_t cy_rtos_queue_get(cy_queue_t* queue, void* item_ptr, cy_time_t timeout_ms);
 
+/** Put several items in a queue.
+ *
+ * This function puts up to num_items items, stored back to back in items, in the queue in
+ * order. It only waits (up to timeout_ms) while the queue is full and no item has been put yet;
+ * once an item is put it puts as many of the rest as fit and returns. The items are put with
+ * the scheduler locked, so a thread waiting on the queue is switched to once for the whole
+ * batch instead of once per item.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  queue      Pointer to the queue handle
+ * @param[in]  items      Pointer to the items to place in the queue
+ * @param[in]  itemsize   The size of each item, this must be the itemsize the queue was
+ *                        initialized with
+ * @param[in]  num_items  The number of items to place in the queue
+ * @param[out] num_put    Pointer to the number of items placed in the queue
+ * @param[in]  timeout_ms The time to wait for space for the first item
+ *
+ * @return The status of the put request, \ref CY_RSLT_SUCCESS if at least one item was put.
+ *         [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_QUEUE_FULL, \ref
+ *         CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_queue_put_n(cy_queue_t* queue, const void* items, size_t itemsize,
+                              size_t num_items, size_t* num_put, cy_time_t timeout_ms);
+
+/** Get several items from a queue.
+ *
+ * This function gets up to num_items items from the queue and stores them back to back in
+ * items. It only waits (up to timeout_ms) while the queue is empty; once an item is available
+ * it gets as many as are queued, up to num_items, and returns. The items are taken with the
+ * scheduler locked, so a thread waiting for space is switched to once for the whole batch
+ * instead of once per item.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  queue      Pointer to the queue handle
+ * @param[out] items      Pointer to the memory for num_items items from the queue
+ * @param[in]  itemsize   The size of each item, this must be the itemsize the queue was
+ *                        initialized with
+ * @param[in]  num_items  The maximum number of items to get from the queue
+ * @param[out] num_got    Pointer to the number of items taken from the queue
+ * @param[in]  timeout_ms The time to wait for the first item
+ *
+ * @return The status of the get request, \ref CY_RSLT_SUCCESS if at least one item was taken.
+ *         [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_QUEUE_EMPTY, \ref
+ *         CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_queue_get_n(cy_queue_t* queue, void* items, size_t itemsize,
+                              size_t num_items, size_t* num_got, cy_time_t timeout_ms);
+
 /** Return the number of items in the queue.
  *
  * This function returns the number of items currently in the queue.
@@ -714,6 +815,583 @@ cy_rslt_t cy_rtos_queue_deinit(cy_queue_t* queue);
 
 /** \} group_abstraction_rtos_queue */
 
+/******************************************* Slot Queues ******************************************/
+
+/**
+ * \ingroup group_abstraction_rtos_slot_queue
+ * \{
+ */
+
+/** Size of one slot of a slot queue holding items of itemsize bytes */
+#define CY_RTOS_SLOT_SIZE(itemsize) \
+    (((itemsize) + CY_RTOS_ALIGNMENT_MASK) & ~CY_RTOS_ALIGNMENT_MASK)
+
+/** Number of bytes needed by \ref cy_rtos_slot_queue_init_static for length items of itemsize
+ * bytes */
+#define CY_RTOS_SLOT_QUEUE_STORAGE_SIZE(length, itemsize)                                      \
+    ((2U * ((CY_RTOS_QUEUE_STORAGE_SIZE((length), sizeof(void*)) + CY_RTOS_ALIGNMENT_MASK) &    \
+            ~CY_RTOS_ALIGNMENT_MASK)) + ((length) * CY_RTOS_SLOT_SIZE(itemsize)))
+
+/** A queue of fixed size items that are built and consumed in place.
+ *
+ * A producer reserves a free slot, fills it through the returned pointer and commits it. A
+ * consumer acquires the oldest committed slot, reads it through the returned pointer and
+ * releases it. Only the slot pointer passes through the RTOS queues, so items are never copied.
+ * The fields are internal and must not be accessed directly.
+ */
+typedef struct
+{
+    cy_queue_t free;      /**< Slots that can be reserved */
+    cy_queue_t ready;     /**< Committed slots in commit order */
+    void*      slots;     /**< Slot memory */
+    void*      mem;       /**< Memory to release on deinit, or NULL if caller owned */
+    size_t     slot_size; /**< Size of each slot */
+    size_t     length;    /**< Number of slots */
+} cy_slot_queue_t;
+
+/** Create a slot queue.
+ *
+ * @param[out] queue    Pointer to the slot queue handle
+ * @param[in]  length   The number of slots in the queue
+ * @param[in]  itemsize The size of each item in the queue
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_slot_queue_init(cy_slot_queue_t* queue, size_t length, size_t itemsize);
+
+/** Create a slot queue without allocating any memory.
+ *
+ * Same as \ref cy_rtos_slot_queue_init, but the caller provides the memory for the queue. The
+ * memory must stay valid until \ref cy_rtos_slot_queue_deinit has returned for the queue.
+ *
+ * @param[out] queue    Pointer to the slot queue handle
+ * @param[in]  length   The number of slots in the queue
+ * @param[in]  itemsize The size of each item in the queue
+ * @param[in]  storage  Memory for the queue. This must be aligned to \ref CY_RTOS_ALIGNMENT_MASK
+ *                      and hold \ref CY_RTOS_SLOT_QUEUE_STORAGE_SIZE(length, itemsize) bytes.
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR,
+ *         \ref CY_RTOS_BAD_PARAM, \ref CY_RTOS_ALIGNMENT_ERROR]
+ */
+cy_rslt_t cy_rtos_slot_queue_init_static(cy_slot_queue_t* queue, size_t length, size_t itemsize,
+                                         void* storage);
+
+/** Reserve a free slot to build an item in.
+ *
+ * The slot belongs to the caller until it is passed to \ref cy_rtos_slot_queue_commit, or to
+ * \ref cy_rtos_slot_queue_release to give it back unused.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  queue      Pointer to the slot queue handle
+ * @param[out] slot       Receives a pointer to the slot, aligned to \ref CY_RTOS_ALIGNMENT
+ * @param[in]  timeout_ms The time to wait for a free slot
+ *
+ * @return The status of the reserve request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_FULL,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_slot_queue_reserve(cy_slot_queue_t* queue, void** slot, cy_time_t timeout_ms);
+
+/** Place a reserved slot at the back of the queue.
+ *
+ * The slot must not be accessed by the producer once it is committed.
+ *
+ * @param[in] queue Pointer to the slot queue handle
+ * @param[in] slot  Slot returned by \ref cy_rtos_slot_queue_reserve
+ *
+ * @return The status of the commit request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_slot_queue_commit(cy_slot_queue_t* queue, void* slot);
+
+/** Take the slot at the front of the queue to consume the item in place.
+ *
+ * The slot belongs to the caller until it is passed to \ref cy_rtos_slot_queue_release.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  queue      Pointer to the slot queue handle
+ * @param[out] slot       Receives a pointer to the slot
+ * @param[in]  timeout_ms The time to wait for a committed slot
+ *
+ * @return The status of the acquire request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_EMPTY,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_slot_queue_acquire(cy_slot_queue_t* queue, void** slot, cy_time_t timeout_ms);
+
+/** Return a slot to the queue so it can be reserved again.
+ *
+ * @param[in] queue Pointer to the slot queue handle
+ * @param[in] slot  Slot returned by \ref cy_rtos_slot_queue_acquire or
+ *                  \ref cy_rtos_slot_queue_reserve
+ *
+ * @return The status of the release request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_slot_queue_release(cy_slot_queue_t* queue, void* slot);
+
+/** Return the number of committed slots in the queue.
+ *
+ * @param[in]  queue       Pointer to the slot queue handle
+ * @param[out] num_waiting Pointer to the return count
+ *
+ * @return The status of the count request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR]
+ */
+cy_rslt_t cy_rtos_slot_queue_count(cy_slot_queue_t* queue, size_t* num_waiting);
+
+/** Deinitialize the slot queue handle.
+ *
+ * @param[in] queue Pointer to the slot queue handle
+ *
+ * @return The status of the deinit request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR]
+ */
+cy_rslt_t cy_rtos_slot_queue_deinit(cy_slot_queue_t* queue);
+
+/** \} group_abstraction_rtos_slot_queue */
+
+/********************************************** Rings *********************************************/
+
+/**
+ * \ingroup group_abstraction_rtos_ring
+ * \{
+ */
+
+/** Number of bytes needed by \ref cy_rtos_ring_init_static for length items of itemsize bytes */
+#define CY_RTOS_RING_STORAGE_SIZE(length, itemsize)    ((length) * (itemsize))
+
+/** A ring of fixed size items with one producer and one consumer.
+ *
+ * The producer never blocks and takes no lock or critical section, so it can put items from an
+ * ISR at little cost. The consumer can wait for items; it is woken with its thread
+ * notification, so the consumer thread must not wait on its notification for other purposes
+ * while it uses the ring. The fields are internal and must not be accessed directly.
+ */
+typedef struct
+{
+    uint8_t*          buffer;   /**< Item memory */
+    void*             mem;      /**< Memory to release on deinit, or NULL if caller owned */
+    uint32_t          length;   /**< Number of items, a power of 2 */
+    uint32_t          itemsize; /**< Size of each item */
+    volatile uint32_t head;     /**< Items ever put, only written by the producer */
+    volatile uint32_t tail;     /**< Items ever taken, only written by the consumer */
+    volatile bool     waiting;  /**< Set while the consumer waits for items */
+    cy_thread_t       consumer; /**< Thread to notify while waiting is set */
+} cy_ring_t;
+
+/** Create a ring.
+ *
+ * @param[out] ring     Pointer to the ring handle
+ * @param[in]  length   The maximum number of items in the ring, must be a power of 2
+ * @param[in]  itemsize The size of each item in the ring
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_ring_init(cy_ring_t* ring, size_t length, size_t itemsize);
+
+/** Create a ring without allocating any memory.
+ *
+ * Same as \ref cy_rtos_ring_init, but the caller provides the memory for the items. The memory
+ * must stay valid until \ref cy_rtos_ring_deinit has returned for the ring.
+ *
+ * @param[out] ring     Pointer to the ring handle
+ * @param[in]  length   The maximum number of items in the ring, must be a power of 2
+ * @param[in]  itemsize The size of each item in the ring
+ * @param[in]  storage  Memory of \ref CY_RTOS_RING_STORAGE_SIZE(length, itemsize) bytes
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_ring_init_static(cy_ring_t* ring, size_t length, size_t itemsize,
+                                   void* storage);
+
+/** Put items in a ring.
+ *
+ * Copies as many of the items as fit into the ring and wakes the consumer if it is waiting.
+ * This never blocks and is safe to call from an ISR, but only one thread or ISR may put items
+ * in a given ring.
+ *
+ * @param[in]  ring      Pointer to the ring handle
+ * @param[in]  items     Pointer to the items, stored back to back
+ * @param[in]  num_items The number of items to put
+ * @param[out] num_put   Pointer to the number of items put, may be NULL
+ *
+ * @return The status of the put request, \ref CY_RSLT_SUCCESS if at least one item was put.
+ *         [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_FULL, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_ring_put(cy_ring_t* ring, const void* items, size_t num_items,
+                           size_t* num_put);
+
+/** Get items from a ring.
+ *
+ * Copies up to num_items items out of the ring. If the ring is empty, waits up to timeout_ms
+ * for the producer to put an item. Only one thread may get items from a given ring.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  ring       Pointer to the ring handle
+ * @param[out] items      Pointer to the memory for num_items items
+ * @param[in]  num_items  The maximum number of items to get
+ * @param[out] num_got    Pointer to the number of items taken, may be NULL
+ * @param[in]  timeout_ms The time to wait for the first item
+ *
+ * @return The status of the get request, \ref CY_RSLT_SUCCESS if at least one item was taken.
+ *         [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_EMPTY, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_ring_get(cy_ring_t* ring, void* items, size_t num_items, size_t* num_got,
+                           cy_time_t timeout_ms);
+
+/** Return the number of items in the ring.
+ *
+ * @param[in]  ring        Pointer to the ring handle
+ * @param[out] num_waiting Pointer to the return count
+ *
+ * @return The status of the count request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_ring_count(cy_ring_t* ring, size_t* num_waiting);
+
+/** Deinitialize the ring handle.
+ *
+ * @param[in] ring Pointer to the ring handle
+ *
+ * @return The status of the deinit request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_ring_deinit(cy_ring_t* ring);
+
+/** \} group_abstraction_rtos_ring */
+
+/******************************************* MPMC Queues ******************************************/
+
+/**
+ * \ingroup group_abstraction_rtos_mpmc_queue
+ * \{
+ */
+
+/** Size of one cell of an MPMC queue holding items of itemsize bytes. The cell holds a sequence
+ * number followed by the item. */
+#define CY_RTOS_MPMC_CELL_SIZE(itemsize) \
+    (CY_RTOS_ALIGNMENT + (((itemsize) + CY_RTOS_ALIGNMENT_MASK) & ~CY_RTOS_ALIGNMENT_MASK))
+
+/** Number of bytes needed by \ref cy_rtos_mpmc_queue_init_static for length items of itemsize
+ * bytes */
+#define CY_RTOS_MPMC_QUEUE_STORAGE_SIZE(length, itemsize) \
+    ((length) * CY_RTOS_MPMC_CELL_SIZE(itemsize))
+
+/** A bounded queue of fixed size items with any number of producers and consumers.
+ *
+ * Items are put and taken with a compare-and-swap on the queue position and a copy into or out
+ * of a cell of an array, so threads on different cores, and ISRs, do not serialize on a kernel
+ * lock. The RTOS is only entered through a semaphore when a consumer has to wait for an item and
+ * when an item is put while a consumer waits. The fields are internal and must not be accessed
+ * directly.
+ */
+typedef struct
+{
+    uint8_t*          cells;     /**< Cell memory */
+    void*             mem;       /**< Memory to release on deinit, or NULL if caller owned */
+    uint32_t          mask;      /**< Number of cells, a power of 2, minus 1 */
+    uint32_t          cell_size; /**< Size of each cell */
+    uint32_t          itemsize;  /**< Size of each item */
+    volatile uint32_t put_pos;   /**< Items ever reserved by producers */
+    volatile uint32_t get_pos;   /**< Items ever reserved by consumers */
+    volatile uint32_t waiters;   /**< Consumers waiting for the semaphore that were not woken */
+    cy_semaphore_t    items;     /**< Woken consumers */
+} cy_mpmc_queue_t;
+
+/** Create an MPMC queue.
+ *
+ * @param[out] queue    Pointer to the queue handle
+ * @param[in]  length   The maximum number of items in the queue, must be a power of 2
+ * @param[in]  itemsize The size of each item in the queue
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_mpmc_queue_init(cy_mpmc_queue_t* queue, size_t length, size_t itemsize);
+
+/** Create an MPMC queue in caller provided memory.
+ *
+ * Same as \ref cy_rtos_mpmc_queue_init, but the caller provides the memory for the items. The
+ * memory must stay valid until \ref cy_rtos_mpmc_queue_deinit has returned for the queue. The
+ * semaphore used to wait for items is still created by the RTOS.
+ *
+ * @param[out] queue    Pointer to the queue handle
+ * @param[in]  length   The maximum number of items in the queue, must be a power of 2
+ * @param[in]  itemsize The size of each item in the queue
+ * @param[in]  storage  Memory for the queue. This must be aligned to \ref CY_RTOS_ALIGNMENT_MASK
+ *                      and hold \ref CY_RTOS_MPMC_QUEUE_STORAGE_SIZE(length, itemsize) bytes.
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM, \ref CY_RTOS_ALIGNMENT_ERROR]
+ */
+cy_rslt_t cy_rtos_mpmc_queue_init_static(cy_mpmc_queue_t* queue, size_t length, size_t itemsize,
+                                         void* storage);
+
+/** Put an item in an MPMC queue.
+ *
+ * This never blocks and can be called from an ISR.
+ *
+ * @param[in] queue    Pointer to the queue handle
+ * @param[in] item_ptr Pointer to the item to place in the queue
+ *
+ * @return The status of the put request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_FULL, \ref
+ *         CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_mpmc_queue_put(cy_mpmc_queue_t* queue, const void* item_ptr);
+
+/** Get an item from an MPMC queue.
+ *
+ * If the queue is empty, waits up to timeout_ms for an item to be put.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  queue      Pointer to the queue handle
+ * @param[out] item_ptr   Pointer to the memory for the item from the queue
+ * @param[in]  timeout_ms The time to wait for an item
+ *
+ * @return The status of the get request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_EMPTY, \ref
+ *         CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_mpmc_queue_get(cy_mpmc_queue_t* queue, void* item_ptr, cy_time_t timeout_ms);
+
+/** Return the number of items in the MPMC queue.
+ *
+ * Puts and gets in progress on other threads may or may not be counted.
+ *
+ * @param[in]  queue       Pointer to the queue handle
+ * @param[out] num_waiting Pointer to the return count
+ *
+ * @return The status of the count request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_mpmc_queue_count(cy_mpmc_queue_t* queue, size_t* num_waiting);
+
+/** Deinitialize the MPMC queue handle.
+ *
+ * @param[in] queue Pointer to the queue handle
+ *
+ * @return The status of the deinit request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_mpmc_queue_deinit(cy_mpmc_queue_t* queue);
+
+/** \} group_abstraction_rtos_mpmc_queue */
+
+/*********************************** Stream and Message Buffers ***********************************/
+
+/**
+ * \ingroup group_abstraction_rtos_stream_buffer
+ * \{
+ */
+
+// Ports with native stream buffers define their own buffer types and storage size
+#if !defined(CY_RTOS_NATIVE_STREAM_BUFFER)
+/** Number of bytes needed by \ref cy_rtos_stream_buffer_init_static or \ref
+ * cy_rtos_message_buffer_init_static for a buffer of size bytes */
+#define CY_RTOS_STREAM_BUFFER_STORAGE_SIZE(size)    ((size) + 1U)
+
+/** Number of bytes of a message buffer taken by the length stored with each message */
+#define CY_RTOS_MESSAGE_LENGTH_SIZE                 (sizeof(size_t))
+
+/** A buffer of bytes with one writer and one reader.
+ *
+ * Used by ports whose RTOS has no stream buffers. The bytes are kept in a ring that the writer
+ * and the reader update without a lock, and each side only enters the RTOS through a semaphore
+ * when it has to wait for the other. The fields are internal and must not be accessed directly.
+ */
+typedef struct
+{
+    uint8_t*          buffer;         /**< Byte memory */
+    void*             mem;            /**< Memory to release on deinit, or NULL if caller owned */
+    uint32_t          length;         /**< Size of the byte memory, one more than the capacity */
+    uint32_t          trigger_level;  /**< Bytes needed to wake a waiting reader */
+    volatile uint32_t head;           /**< Next byte to write, only changed by the writer */
+    volatile uint32_t tail;           /**< Next byte to read, only changed by the reader */
+    volatile bool     reader_waiting; /**< Set while the reader may block on data */
+    volatile bool     writer_waiting; /**< Set while the writer may block on space */
+    cy_semaphore_t    data;           /**< Wakes the reader */
+    cy_semaphore_t    space;          /**< Wakes the writer */
+} cy_stream_buffer_t;
+
+/** A buffer of variable length messages with one writer and one reader. */
+typedef cy_stream_buffer_t cy_message_buffer_t;
+#endif // !defined(CY_RTOS_NATIVE_STREAM_BUFFER)
+
+/** Number of bytes needed by \ref cy_rtos_message_buffer_init_static for a buffer of size
+ * bytes. Each message takes its length plus \ref CY_RTOS_MESSAGE_LENGTH_SIZE bytes. */
+#define CY_RTOS_MESSAGE_BUFFER_STORAGE_SIZE(size)   CY_RTOS_STREAM_BUFFER_STORAGE_SIZE(size)
+
+/** Create a stream buffer.
+ *
+ * A stream buffer passes bytes from one writer to one reader with no framing, so small writes
+ * only take the bytes they need. If more than one thread or ISR writes, or more than one reads,
+ * the callers on that side must serialize their calls.
+ *
+ * @param[out] buffer        Pointer to the stream buffer handle
+ * @param[in]  size          The number of bytes the buffer can hold
+ * @param[in]  trigger_level The number of bytes that must be in the buffer before a blocked
+ *                           reader is woken, from 1 to size. 0 is treated as 1.
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_stream_buffer_init(cy_stream_buffer_t* buffer, size_t size,
+                                     size_t trigger_level);
+
+/** Create a stream buffer in caller provided memory.
+ *
+ * Same as \ref cy_rtos_stream_buffer_init, but the caller provides the memory for the buffer.
+ * The memory must stay valid until \ref cy_rtos_stream_buffer_deinit has returned for the
+ * buffer.
+ *
+ * @param[out] buffer        Pointer to the stream buffer handle
+ * @param[in]  size          The number of bytes the buffer can hold
+ * @param[in]  trigger_level The number of bytes that must be in the buffer before a blocked
+ *                           reader is woken, from 1 to size. 0 is treated as 1.
+ * @param[in]  storage       Memory for the buffer. This must be aligned to \ref
+ *                           CY_RTOS_ALIGNMENT_MASK and hold \ref
+ *                           CY_RTOS_STREAM_BUFFER_STORAGE_SIZE(size) bytes.
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM, \ref CY_RTOS_ALIGNMENT_ERROR]
+ */
+cy_rslt_t cy_rtos_stream_buffer_init_static(cy_stream_buffer_t* buffer, size_t size,
+                                            size_t trigger_level, void* storage);
+
+/** Write bytes to a stream buffer.
+ *
+ * Writes as many bytes as fit, then waits up to timeout_ms for space for the rest.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  buffer     Pointer to the stream buffer handle
+ * @param[in]  data       Pointer to the bytes to write
+ * @param[in]  length     The number of bytes to write
+ * @param[out] num_sent   Pointer to the number of bytes written, may be NULL
+ * @param[in]  timeout_ms The time to wait for space in the buffer
+ *
+ * @return The status of the send request. [\ref CY_RSLT_SUCCESS if at least one byte was
+ *         written, \ref CY_RTOS_QUEUE_FULL, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_stream_buffer_send(cy_stream_buffer_t* buffer, const void* data, size_t length,
+                                     size_t* num_sent, cy_time_t timeout_ms);
+
+/** Read bytes from a stream buffer.
+ *
+ * If the buffer holds fewer bytes than its trigger level, waits up to timeout_ms for more, then
+ * reads up to length bytes.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  buffer       Pointer to the stream buffer handle
+ * @param[out] data         Pointer to the memory for the bytes
+ * @param[in]  length       The maximum number of bytes to read
+ * @param[out] num_received Pointer to the number of bytes read, may be NULL
+ * @param[in]  timeout_ms   The time to wait for bytes
+ *
+ * @return The status of the receive request. [\ref CY_RSLT_SUCCESS if at least one byte was
+ *         read, \ref CY_RTOS_QUEUE_EMPTY, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_stream_buffer_receive(cy_stream_buffer_t* buffer, void* data, size_t length,
+                                        size_t* num_received, cy_time_t timeout_ms);
+
+/** Return the number of bytes in a stream buffer.
+ *
+ * @param[in]  buffer    Pointer to the stream buffer handle
+ * @param[out] num_bytes Pointer to the return count
+ *
+ * @return The status of the count request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_stream_buffer_count(cy_stream_buffer_t* buffer, size_t* num_bytes);
+
+/** Deinitialize the stream buffer handle.
+ *
+ * @param[in] buffer Pointer to the stream buffer handle
+ *
+ * @return The status of the deinit request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_stream_buffer_deinit(cy_stream_buffer_t* buffer);
+
+/** Create a message buffer.
+ *
+ * A message buffer passes whole messages of any length from one writer to one reader. Each
+ * message takes its own length plus \ref CY_RTOS_MESSAGE_LENGTH_SIZE bytes, rather than a slot
+ * sized for the largest message. If more than one thread or ISR sends, or more than one
+ * receives, the callers on that side must serialize their calls.
+ *
+ * @param[out] buffer Pointer to the message buffer handle
+ * @param[in]  size   The number of bytes the buffer can hold, including the stored lengths
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_message_buffer_init(cy_message_buffer_t* buffer, size_t size);
+
+/** Create a message buffer in caller provided memory.
+ *
+ * Same as \ref cy_rtos_message_buffer_init, but the caller provides the memory for the buffer.
+ * The memory must stay valid until \ref cy_rtos_message_buffer_deinit has returned for the
+ * buffer.
+ *
+ * @param[out] buffer  Pointer to the message buffer handle
+ * @param[in]  size    The number of bytes the buffer can hold, including the stored lengths
+ * @param[in]  storage Memory for the buffer. This must be aligned to \ref CY_RTOS_ALIGNMENT_MASK
+ *                     and hold \ref CY_RTOS_MESSAGE_BUFFER_STORAGE_SIZE(size) bytes.
+ *
+ * @return The status of the init request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_NO_MEMORY, \ref
+ *         CY_RTOS_GENERAL_ERROR, \ref CY_RTOS_BAD_PARAM, \ref CY_RTOS_ALIGNMENT_ERROR]
+ */
+cy_rslt_t cy_rtos_message_buffer_init_static(cy_message_buffer_t* buffer, size_t size,
+                                             void* storage);
+
+/** Send a message to a message buffer.
+ *
+ * Waits up to timeout_ms for space for the whole message. A message is never partly sent.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in] buffer     Pointer to the message buffer handle
+ * @param[in] message    Pointer to the message
+ * @param[in] length     The length of the message, at least 1
+ * @param[in] timeout_ms The time to wait for space in the buffer
+ *
+ * @return The status of the send request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_FULL if
+ *         there was no space in time or the message can never fit, \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_message_buffer_send(cy_message_buffer_t* buffer, const void* message,
+                                      size_t length, cy_time_t timeout_ms);
+
+/** Receive the oldest message from a message buffer.
+ *
+ * If the buffer is empty, waits up to timeout_ms for a message. A message longer than
+ * max_length is left in the buffer.
+ *
+ * @note If in_isr is true, timeout_ms must be zero.
+ *
+ * @param[in]  buffer     Pointer to the message buffer handle
+ * @param[out] message    Pointer to the memory for the message
+ * @param[in]  max_length The size of the memory for the message
+ * @param[out] length     Pointer to the length of the message received
+ * @param[in]  timeout_ms The time to wait for a message
+ *
+ * @return The status of the receive request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_QUEUE_EMPTY if
+ *         no message arrived in time, \ref CY_RTOS_BAD_PARAM if the next message is longer
+ *         than max_length]
+ */
+cy_rslt_t cy_rtos_message_buffer_receive(cy_message_buffer_t* buffer, void* message,
+                                         size_t max_length, size_t* length, cy_time_t timeout_ms);
+
+/** Deinitialize the message buffer handle.
+ *
+ * @param[in] buffer Pointer to the message buffer handle
+ *
+ * @return The status of the deinit request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_GENERAL_ERROR,
+ *         \ref CY_RTOS_BAD_PARAM]
+ */
+cy_rslt_t cy_rtos_message_buffer_deinit(cy_message_buffer_t* buffer);
+
+/** \} group_abstraction_rtos_stream_buffer */
+
 /********************************************* Timers *********************************************/
 
 /**
@@ -30,6 +30,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 #if !defined (COMPONENT_CAT5)
 #include <cmsis_compiler.h>
 #endif
@@ -53,6 +54,107 @@ static inline bool is_in_isr(void)
 }
 
 
+/** Orders the memory accesses before the call against those after it, as seen by other cores,
+ * DMA and interrupt handlers.
+ */
+static inline void cy_rtos_memory_barrier(void)
+{
+    #if defined(COMPONENT_CAT5)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    #else
+    __DMB();
+    #endif
+}
+
+
+/** Atomically replaces a value if it still holds the expected value.
+ *
+ * Uses exclusive load/store where the core supports it so that interrupts are never masked.
+ * On cores without exclusive access (Armv6-M) interrupts are masked for the few instructions
+ * of the compare and store. On every core the update is a full memory barrier, so a pointer
+ * published with it can be followed on another core without further barriers.
+ *
+ * @param[in,out] ptr       Value to update
+ * @param[in]     expected  Value that ptr must hold for the update to happen
+ * @param[in]     desired   New value to store
+ *
+ * @return true if the value was replaced, false if it did not hold the expected value
+ */
+static inline bool cy_rtos_atomic_cas(volatile uint32_t* ptr, uint32_t expected, uint32_t desired)
+{
+    #if !defined(COMPONENT_CAT5) && \
+    (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__) || \
+    defined(__ARM_ARCH_8_1M_MAIN__))
+    // Exclusive accesses do not order other accesses, so match the sequentially consistent
+    // __atomic fallback with a barrier on each side of the store
+    __DMB();
+    do
+    {
+        if (__LDREXW(ptr) != expected)
+        {
+            __CLREX();
+            __DMB();
+            return false;
+        }
+    } while (__STREXW(desired, ptr) != 0U);
+    __DMB();
+    return true;
+    #elif !defined(COMPONENT_CAT5) && defined(__ARM_ARCH_6M__)
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool replaced = (*ptr == expected);
+    if (replaced)
+    {
+        *ptr = desired;
+    }
+    __set_PRIMASK(primask);
+    return replaced;
+    #else // Cortex-A, Cortex-R and devices without CMSIS
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+    #endif
+}
+
+
+/** Atomically adds to a value.
+ *
+ * @param[in,out] ptr    Value to update
+ * @param[in]     delta  Amount to add; unsigned wrap-around allows subtracting
+ *
+ * @return The updated value
+ */
+static inline uint32_t cy_rtos_atomic_add(volatile uint32_t* ptr, uint32_t delta)
+{
+    uint32_t value;
+    do
+    {
+        value = *ptr;
+    } while (!cy_rtos_atomic_cas(ptr, value, value + delta));
+    return value + delta;
+}
+
+
+/** Atomically replaces a pointer if it still holds the expected value.
+ *
+ * @param[in,out] ptr       Pointer to update
+ * @param[in]     expected  Value that ptr must hold for the update to happen
+ * @param[in]     desired   New value to store
+ *
+ * @return true if the pointer was replaced, false if it did not hold the expected value
+ */
+static inline bool cy_rtos_atomic_cas_ptr(void* volatile* ptr, void* expected, void* desired)
+{
+    #if (UINTPTR_MAX == UINT32_MAX)
+    return cy_rtos_atomic_cas((volatile uint32_t*)ptr, (uint32_t)(uintptr_t)expected,
+                              (uint32_t)(uintptr_t)desired);
+    #else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+    #endif
+}
+
+
 #if defined(__cplusplus)
 }
 #endif
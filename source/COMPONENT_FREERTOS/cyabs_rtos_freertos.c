@@ -71,13 +71,35 @@ cy_rtos_error_t cy_rtos_last_error(void)
 // Threads
 //==================================================================================================
 
-typedef struct
+typedef cy_thread_cb_t cy_task_wrapper_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// thread_start
+//
+/* Starts a thread whose control block and stack have already been set up.
+ * @param thread : receives the new thread handle
+ * @param wrapper : control block of the thread
+ * @param memptr : memory to release when the thread is joined, or NULL if caller owned
+ * @param stack : stack of the thread
+ */
+//--------------------------------------------------------------------------------------------------
+static void thread_start(cy_thread_t* thread, cy_task_wrapper_t* wrapper, void* memptr,
+                         cy_thread_entry_fn_t entry_function, const char* name,
+                         StackType_t* stack, uint32_t stack_size, cy_thread_priority_t priority,
+                         cy_thread_arg_t arg)
 {
-    StaticTask_t      task;
-    SemaphoreHandle_t sema;
-    uint32_t          magic;
-    void*             memptr;
-} cy_task_wrapper_t;
+    StackType_t stack_size_rtos = ((stack_size & ~CY_RTOS_ALIGNMENT_MASK) / sizeof(StackType_t));
+
+    wrapper->sema = xSemaphoreCreateBinaryStatic(&(wrapper->sema_mem));
+    CY_ASSERT(wrapper->sema != NULL);
+    wrapper->magic  = TASK_IDENT;
+    wrapper->memptr = memptr;
+    CY_ASSERT(((uint32_t)wrapper & CY_RTOS_ALIGNMENT_MASK) == 0UL);
+    *thread = xTaskCreateStatic((TaskFunction_t)entry_function, name, stack_size_rtos, arg,
+                                (UBaseType_t)priority, stack, &(wrapper->task));
+    CY_ASSERT(((void*)*thread == (void*)&(wrapper->task)) || (*thread == NULL));
+}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -120,21 +142,12 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
         }
         else
         {
-            StackType_t stack_size_rtos =
-                ((stack_size & ~CY_RTOS_ALIGNMENT_MASK) / sizeof(StackType_t));
             StackType_t* stack_rtos = (stack == NULL)
                 ? (StackType_t*)ident
                 : (StackType_t*)stack;
 
-            cy_task_wrapper_t* wrapper = (cy_task_wrapper_t*)(ident + offset);
-            wrapper->sema = xSemaphoreCreateBinary();
-            CY_ASSERT(wrapper->sema != NULL);
-            wrapper->magic  = TASK_IDENT;
-            wrapper->memptr = ident;
-            CY_ASSERT(((uint32_t)wrapper & CY_RTOS_ALIGNMENT_MASK) == 0UL);
-            *thread = xTaskCreateStatic((TaskFunction_t)entry_function, name, stack_size_rtos, arg,
-                                        (UBaseType_t)priority, stack_rtos, &(wrapper->task));
-            CY_ASSERT(((void*)*thread == (void*)&(wrapper->task)) || (*thread == NULL));
+            thread_start(thread, (cy_task_wrapper_t*)(ident + offset), ident, entry_function,
+                         name, stack_rtos, stack_size, priority, arg);
             status = CY_RSLT_SUCCESS;
         }
     }
@@ -142,6 +155,36 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_create_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_create_static(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
+                                       const char* name, void* stack, uint32_t stack_size,
+                                       cy_thread_priority_t priority, cy_thread_arg_t arg,
+                                       cy_thread_cb_t* cb)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (stack == NULL) || (cb == NULL) ||
+        (stack_size < CY_RTOS_MIN_STACK_SIZE))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if ((0 != (((uint32_t)stack) & CY_RTOS_ALIGNMENT_MASK)) ||
+             (0 != (((uint32_t)cb) & CY_RTOS_ALIGNMENT_MASK)))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        // The memory belongs to the caller, so there is nothing for join to free
+        thread_start(thread, cb, NULL, entry_function, name, (StackType_t*)stack, stack_size,
+                     priority, arg);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_thread_exit
 //--------------------------------------------------------------------------------------------------
@@ -208,7 +251,10 @@ cy_rslt_t cy_rtos_thread_terminate(cy_thread_t* thread)
         {
             wrapper->magic = 0;
             vSemaphoreDelete(wrapper->sema);
-            vPortFree(wrapper->memptr);
+            if (wrapper->memptr != NULL)
+            {
+                vPortFree(wrapper->memptr);
+            }
         }
         xTaskResumeAll();
         status = CY_RSLT_SUCCESS;
@@ -945,6 +991,34 @@ cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_init_static(cy_queue_t* queue, size_t length, size_t itemsize,
+                                    void* storage)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (storage == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if (0 != (((uint32_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        // The control block comes first, followed by the items
+        uint32_t offset = (sizeof(StaticQueue_t) + CY_RTOS_ALIGNMENT_MASK) &
+                          ~CY_RTOS_ALIGNMENT_MASK;
+        *queue = xQueueCreateStatic(length, itemsize, (uint8_t*)storage + offset,
+                                    (StaticQueue_t*)storage);
+        status = (*queue == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
 #if defined(FREERTOS_COMMON_SECTION_BEGIN)
 FREERTOS_COMMON_SECTION_BEGIN
 #endif
@@ -1043,6 +1117,212 @@ FREERTOS_COMMON_SECTION_END
 #endif
 
 
+#if defined(FREERTOS_COMMON_SECTION_BEGIN)
+FREERTOS_COMMON_SECTION_BEGIN
+#endif
+//--------------------------------------------------------------------------------------------------
+// queue_itemsize_valid
+//
+/* Checks the item size passed to a batch request. Kernels before V10.5.0 cannot report the
+ * item size of a queue, so there only an item size of 0 is refused.
+ * @param queue : queue the items are for
+ * @param itemsize : size of each item given by the caller
+ * @return true if the item size can be used with the queue
+ */
+//--------------------------------------------------------------------------------------------------
+static bool queue_itemsize_valid(QueueHandle_t queue, size_t itemsize)
+{
+    #if (tskKERNEL_VERSION_MAJOR > 10) || \
+    ((tskKERNEL_VERSION_MAJOR == 10) && (tskKERNEL_VERSION_MINOR >= 5))
+    return (itemsize != 0) && (itemsize == (size_t)uxQueueGetQueueItemSize(queue));
+    #else
+    CY_UNUSED_PARAMETER(queue);
+    return (itemsize != 0);
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// queue_put_available
+//
+/* Puts items in a queue, without waiting, until one does not fit.
+ * @param queue : queue to put the items in
+ * @param items : items stored back to back
+ * @param itemsize : size of each item
+ * @param first : index of the first item to put
+ * @param num_items : number of items
+ * @param woken : set if a higher priority task was woken, or NULL when not called from an ISR
+ * @return index after the last item put
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t queue_put_available(QueueHandle_t queue, const uint8_t* items, size_t itemsize,
+                                  size_t first, size_t num_items, BaseType_t* woken)
+{
+    size_t count = first;
+    while (count < num_items)
+    {
+        const uint8_t* item = &items[count * itemsize];
+        BaseType_t     ret  = (woken != NULL)
+            ? xQueueSendToBackFromISR(queue, item, woken)
+            : xQueueSendToBack(queue, item, 0);
+        if (ret == pdFALSE)
+        {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// queue_get_available
+//
+/* Gets items from a queue, without waiting, until it is empty.
+ * @param queue : queue to get the items from
+ * @param items : memory for the items stored back to back
+ * @param itemsize : size of each item
+ * @param first : index of the first item to get
+ * @param num_items : maximum number of items
+ * @param woken : set if a higher priority task was woken, or NULL when not called from an ISR
+ * @return index after the last item taken
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t queue_get_available(QueueHandle_t queue, uint8_t* items, size_t itemsize,
+                                  size_t first, size_t num_items, BaseType_t* woken)
+{
+    size_t count = first;
+    while (count < num_items)
+    {
+        uint8_t*   item = &items[count * itemsize];
+        BaseType_t ret  = (woken != NULL)
+            ? xQueueReceiveFromISR(queue, item, woken)
+            : xQueueReceive(queue, item, 0);
+        if (ret == pdFALSE)
+        {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_END)
+FREERTOS_COMMON_SECTION_END
+#endif
+
+
+#if defined(FREERTOS_COMMON_SECTION_BEGIN)
+FREERTOS_COMMON_SECTION_BEGIN
+#endif
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_put_n
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_put_n(cy_queue_t* queue, const void* items, size_t itemsize,
+                              size_t num_items, size_t* num_put, cy_time_t timeout_ms)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (items == NULL) || (num_items == 0) || (num_put == NULL) ||
+        !queue_itemsize_valid(*queue, itemsize))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        const uint8_t* bytes = (const uint8_t*)items;
+        size_t         count;
+        if (is_in_isr())
+        {
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+            count = queue_put_available(*queue, bytes, itemsize, 0, num_items,
+                                        &xHigherPriorityTaskWoken);
+            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        }
+        else
+        {
+            // Tasks woken by the items are only switched to once the scheduler is resumed
+            vTaskSuspendAll();
+            count = queue_put_available(*queue, bytes, itemsize, 0, num_items, NULL);
+            (void)xTaskResumeAll();
+
+            // Only the first item waits for space, the rest are put the same way as above
+            if ((count == 0) && (timeout_ms != 0) &&
+                (xQueueSendToBack(*queue, bytes, convert_ms_to_ticks(timeout_ms)) == pdTRUE))
+            {
+                vTaskSuspendAll();
+                count = queue_put_available(*queue, bytes, itemsize, 1, num_items, NULL);
+                (void)xTaskResumeAll();
+            }
+        }
+
+        *num_put = count;
+        status   = (count == 0) ? CY_RTOS_QUEUE_FULL : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_END)
+FREERTOS_COMMON_SECTION_END
+#endif
+
+
+#if defined(FREERTOS_COMMON_SECTION_BEGIN)
+FREERTOS_COMMON_SECTION_BEGIN
+#endif
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_get_n
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_get_n(cy_queue_t* queue, void* items, size_t itemsize,
+                              size_t num_items, size_t* num_got, cy_time_t timeout_ms)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (items == NULL) || (num_items == 0) || (num_got == NULL) ||
+        !queue_itemsize_valid(*queue, itemsize))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        uint8_t* bytes = (uint8_t*)items;
+        size_t   count;
+        if (is_in_isr())
+        {
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+            count = queue_get_available(*queue, bytes, itemsize, 0, num_items,
+                                        &xHigherPriorityTaskWoken);
+            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        }
+        else
+        {
+            // Tasks waiting for space are only switched to once the scheduler is resumed
+            vTaskSuspendAll();
+            count = queue_get_available(*queue, bytes, itemsize, 0, num_items, NULL);
+            (void)xTaskResumeAll();
+
+            // Only the first item is waited for, the rest are taken the same way as above
+            if ((count == 0) && (timeout_ms != 0) &&
+                (xQueueReceive(*queue, bytes, convert_ms_to_ticks(timeout_ms)) == pdTRUE))
+            {
+                vTaskSuspendAll();
+                count = queue_get_available(*queue, bytes, itemsize, 1, num_items, NULL);
+                (void)xTaskResumeAll();
+            }
+        }
+
+        *num_got = count;
+        status   = (count == 0) ? CY_RTOS_QUEUE_EMPTY : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_END)
+FREERTOS_COMMON_SECTION_END
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_count
 //--------------------------------------------------------------------------------------------------
@@ -1129,6 +1409,295 @@ cy_rslt_t cy_rtos_queue_deinit(cy_queue_t* queue)
 }
 
 
+//==================================================================================================
+// Stream and Message Buffers
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_init(cy_stream_buffer_t* buffer, size_t size,
+                                     size_t trigger_level)
+{
+    cy_rslt_t status;
+    if ((buffer == NULL) || (size == 0) || (trigger_level > size))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        *buffer = xStreamBufferCreate(size, trigger_level);
+        status  = (*buffer == NULL) ? CY_RTOS_NO_MEMORY : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_init_static(cy_stream_buffer_t* buffer, size_t size,
+                                            size_t trigger_level, void* storage)
+{
+    cy_rslt_t status;
+    if ((buffer == NULL) || (storage == NULL) || (size == 0) || (trigger_level > size))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if (0 != (((uint32_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        // The control block comes first, followed by the bytes
+        uint32_t offset = (sizeof(StaticStreamBuffer_t) + CY_RTOS_ALIGNMENT_MASK) &
+                          ~CY_RTOS_ALIGNMENT_MASK;
+        *buffer = xStreamBufferCreateStatic(size, trigger_level, (uint8_t*)storage + offset,
+                                            (StaticStreamBuffer_t*)storage);
+        status = (*buffer == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_BEGIN)
+FREERTOS_COMMON_SECTION_BEGIN
+#endif
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_send
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_send(cy_stream_buffer_t* buffer, const void* data, size_t length,
+                                     size_t* num_sent, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (data == NULL) || (length == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    size_t sent;
+    if (is_in_isr())
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        sent = xStreamBufferSendFromISR(*buffer, data, length, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        sent = xStreamBufferSend(*buffer, data, length, convert_ms_to_ticks(timeout_ms));
+    }
+
+    if (num_sent != NULL)
+    {
+        *num_sent = sent;
+    }
+    return (sent == 0) ? CY_RTOS_QUEUE_FULL : CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_receive
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_receive(cy_stream_buffer_t* buffer, void* data, size_t length,
+                                        size_t* num_received, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (data == NULL) || (length == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    size_t received;
+    if (is_in_isr())
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        received = xStreamBufferReceiveFromISR(*buffer, data, length, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        received = xStreamBufferReceive(*buffer, data, length, convert_ms_to_ticks(timeout_ms));
+    }
+
+    if (num_received != NULL)
+    {
+        *num_received = received;
+    }
+    return (received == 0) ? CY_RTOS_QUEUE_EMPTY : CY_RSLT_SUCCESS;
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_END)
+FREERTOS_COMMON_SECTION_END
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_count(cy_stream_buffer_t* buffer, size_t* num_bytes)
+{
+    if ((buffer == NULL) || (num_bytes == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    *num_bytes = xStreamBufferBytesAvailable(*buffer);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_deinit(cy_stream_buffer_t* buffer)
+{
+    if (buffer == NULL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    vStreamBufferDelete(*buffer);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_init(cy_message_buffer_t* buffer, size_t size)
+{
+    cy_rslt_t status;
+    if ((buffer == NULL) || (size <= CY_RTOS_MESSAGE_LENGTH_SIZE))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        *buffer = xMessageBufferCreate(size);
+        status  = (*buffer == NULL) ? CY_RTOS_NO_MEMORY : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_init_static(cy_message_buffer_t* buffer, size_t size,
+                                             void* storage)
+{
+    cy_rslt_t status;
+    if ((buffer == NULL) || (storage == NULL) || (size <= CY_RTOS_MESSAGE_LENGTH_SIZE))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if (0 != (((uint32_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        // The control block comes first, followed by the bytes
+        uint32_t offset = (sizeof(StaticMessageBuffer_t) + CY_RTOS_ALIGNMENT_MASK) &
+                          ~CY_RTOS_ALIGNMENT_MASK;
+        *buffer = xMessageBufferCreateStatic(size, (uint8_t*)storage + offset,
+                                             (StaticMessageBuffer_t*)storage);
+        status = (*buffer == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_BEGIN)
+FREERTOS_COMMON_SECTION_BEGIN
+#endif
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_send
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_send(cy_message_buffer_t* buffer, const void* message,
+                                      size_t length, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (message == NULL) || (length == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    // FreeRTOS returns 0 right away for a message that can never fit
+    size_t sent;
+    if (is_in_isr())
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        sent = xMessageBufferSendFromISR(*buffer, message, length, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        sent = xMessageBufferSend(*buffer, message, length, convert_ms_to_ticks(timeout_ms));
+    }
+    return (sent == 0) ? CY_RTOS_QUEUE_FULL : CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_receive
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_receive(cy_message_buffer_t* buffer, void* message,
+                                         size_t max_length, size_t* length, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (message == NULL) || (length == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    if (is_in_isr())
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        *length = xMessageBufferReceiveFromISR(*buffer, message, max_length,
+                                               &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        *length = xMessageBufferReceive(*buffer, message, max_length,
+                                        convert_ms_to_ticks(timeout_ms));
+    }
+
+    if (*length != 0)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+    // Nothing is received either when the wait ran out or when the next message is too long. A
+    // message may arrive right after the wait, so only one too long for the caller is an error.
+    #if (tskKERNEL_VERSION_MAJOR > 10) || \
+    ((tskKERNEL_VERSION_MAJOR == 10) && (tskKERNEL_VERSION_MINOR >= 2))
+    return (xMessageBufferNextLengthBytes(*buffer) > max_length)
+        ? CY_RTOS_BAD_PARAM
+        : CY_RTOS_QUEUE_EMPTY;
+    #else
+    // The length of the next message cannot be read, so a message that fits may be misreported
+    // as too long when it arrives right after the wait
+    return (xMessageBufferIsEmpty(*buffer) == pdTRUE) ? CY_RTOS_QUEUE_EMPTY : CY_RTOS_BAD_PARAM;
+    #endif
+}
+
+
+#if defined(FREERTOS_COMMON_SECTION_END)
+FREERTOS_COMMON_SECTION_END
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_deinit(cy_message_buffer_t* buffer)
+{
+    if (buffer == NULL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    vMessageBufferDelete(*buffer);
+    return CY_RSLT_SUCCESS;
+}
+
+
 //==================================================================================================
 // Timers
 //==================================================================================================
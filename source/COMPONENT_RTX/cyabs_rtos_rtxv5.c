@@ -34,6 +34,8 @@ extern "C" {
 #endif
 
 #define CY_RTOS_THREAD_FLAG 0x01
+// Marks thread and queue control blocks whose memory is owned by the caller
+#define CY_RTOS_STATIC_IDENT (0xABCDEF02U)
 
 /******************************************************
 *                 Error Converter
@@ -131,6 +133,27 @@ static uint32_t convert_ms_to_ticks(cy_time_t timeout_ms)
 *                 Threads
 ******************************************************/
 
+//--------------------------------------------------------------------------------------------------
+// thread_start
+//
+// Starts a thread in the control block and stack set in attr, tagging the control block with
+// ident so that join knows whether to free it
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t thread_start(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
+                              cy_thread_arg_t arg, osThreadAttr_t* attr, uint32_t ident)
+{
+    ((cy_thread_cb_t*)attr->cb_mem)->magic = ident;
+    CY_ASSERT(((uint32_t)attr->cb_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
+    CY_ASSERT(((uint32_t)attr->stack_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
+    *thread = osThreadNew((osThreadFunc_t)entry_function, arg, attr);
+    CY_ASSERT((*thread == attr->cb_mem) || (*thread == NULL));
+    return (*thread == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_create
+//--------------------------------------------------------------------------------------------------
 cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
                                 const char* name, void* stack, uint32_t stack_size,
                                 cy_thread_priority_t priority, cy_thread_arg_t arg)
@@ -160,17 +183,17 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
         if ((uint32_t*)stack == NULL)
         {
             // Note: 1 malloc so that it can be freed with 1 call when terminating
-            uint32_t cb_mem_pad = (~osRtxThreadCbSize + 1) & CY_RTOS_ALIGNMENT_MASK;
-            attr.cb_mem = malloc(osRtxThreadCbSize + cb_mem_pad + stack_size);
+            uint32_t cb_mem_pad = (~sizeof(cy_thread_cb_t) + 1) & CY_RTOS_ALIGNMENT_MASK;
+            attr.cb_mem = malloc(sizeof(cy_thread_cb_t) + cb_mem_pad + stack_size);
             if (attr.cb_mem != NULL)
             {
                 attr.stack_mem =
-                    (uint32_t*)((uint32_t)attr.cb_mem + osRtxThreadCbSize + cb_mem_pad);
+                    (uint32_t*)((uint32_t)attr.cb_mem + sizeof(cy_thread_cb_t) + cb_mem_pad);
             }
         }
         else
         {
-            attr.cb_mem    = malloc(osRtxThreadCbSize);
+            attr.cb_mem    = malloc(sizeof(cy_thread_cb_t));
             attr.stack_mem = stack;
         }
 
@@ -180,11 +203,7 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
         }
         else
         {
-            CY_ASSERT(((uint32_t)attr.cb_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
-            CY_ASSERT(((uint32_t)attr.stack_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
-            *thread = osThreadNew((osThreadFunc_t)entry_function, arg, &attr);
-            CY_ASSERT((*thread == attr.cb_mem) || (*thread == NULL));
-            status = (*thread == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+            status = thread_start(thread, entry_function, arg, &attr, 0U);
         }
     }
 
@@ -192,6 +211,46 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_create_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_create_static(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
+                                       const char* name, void* stack, uint32_t stack_size,
+                                       cy_thread_priority_t priority, cy_thread_arg_t arg,
+                                       cy_thread_cb_t* cb)
+{
+    cy_rslt_t      status = CY_RSLT_SUCCESS;
+    osThreadAttr_t attr;
+
+    if ((thread == NULL) || (stack == NULL) || (cb == NULL) ||
+        (stack_size < CY_RTOS_MIN_STACK_SIZE))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if ((0 != (((uint32_t)stack) & CY_RTOS_ALIGNMENT_MASK)) ||
+             (0 != (((uint32_t)cb) & CY_RTOS_ALIGNMENT_MASK)))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        attr.name       = name;
+        attr.attr_bits  = osThreadJoinable;
+        attr.cb_mem     = cb;
+        attr.cb_size    = osRtxThreadCbSize;
+        attr.stack_mem  = stack;
+        attr.stack_size = stack_size;
+        attr.priority   = (osPriority_t)priority;
+        attr.tz_module  = 0;
+        attr.reserved   = 0;
+
+        status = thread_start(thread, entry_function, arg, &attr, CY_RTOS_STATIC_IDENT);
+    }
+
+    return status;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_thread_exit
 //--------------------------------------------------------------------------------------------------
@@ -311,7 +370,10 @@ cy_rslt_t cy_rtos_thread_join(cy_thread_t* thread)
 
         if (status == CY_RSLT_SUCCESS)
         {
-            free(*thread);
+            if (((cy_thread_cb_t*)*thread)->magic != CY_RTOS_STATIC_IDENT)
+            {
+                free(*thread);
+            }
             *thread = NULL;
         }
     }
@@ -858,10 +920,42 @@ cy_rslt_t cy_rtos_event_deinit(cy_event_t* event)
 *                 Queues
 ******************************************************/
 
-cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
+//--------------------------------------------------------------------------------------------------
+// queue_start
+//
+// Creates a queue in memory of CY_RTOS_QUEUE_STORAGE_SIZE bytes. The control block is followed
+// by ident, which tells deinit whether to free the memory, and then by the messages.
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t queue_start(cy_queue_t* queue, size_t length, size_t itemsize, void* mem,
+                             uint32_t ident)
 {
-    cy_rslt_t            status;
     osMessageQueueAttr_t attr;
+    uint32_t             cb_mem_size =
+        (osRtxMessageQueueCbSize + sizeof(uint32_t) + CY_RTOS_ALIGNMENT_MASK) &
+        ~CY_RTOS_ALIGNMENT_MASK;
+
+    attr.name      = NULL;
+    attr.attr_bits = 0U;
+    attr.cb_mem    = mem;
+    attr.cb_size   = osRtxMessageQueueCbSize;
+    attr.mq_mem    = (uint32_t*)((uint32_t)mem + cb_mem_size);
+    attr.mq_size   = osRtxMessageQueueMemSize(length, itemsize);
+    *(uint32_t*)((uint32_t)mem + osRtxMessageQueueCbSize) = ident;
+
+    CY_ASSERT(((uint32_t)attr.cb_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
+    CY_ASSERT(((uint32_t)attr.mq_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
+    *queue = osMessageQueueNew(length, itemsize, &attr);
+    CY_ASSERT((*queue == attr.cb_mem) || (*queue == NULL));
+    return (*queue == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
+{
+    cy_rslt_t status;
 
     if (queue == NULL)
     {
@@ -869,31 +963,15 @@ cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
     }
     else
     {
-        attr.name      = NULL;
-        attr.attr_bits = 0U;
-        attr.cb_size   = osRtxMessageQueueCbSize;
-        uint32_t blockSize = ((itemsize + 3U) & ~3UL) + sizeof(osRtxMessage_t);
-        attr.mq_size = blockSize * length;
-
         // Note: 1 malloc for both so that they can be freed with 1 call
-        uint32_t cb_mem_pad = (8 - (osRtxMessageQueueCbSize & 0x07)) & 0x07;
-        attr.cb_mem = malloc(osRtxMessageQueueCbSize + cb_mem_pad + attr.mq_size);
-        if (attr.cb_mem != NULL)
-        {
-            attr.mq_mem = (uint32_t*)((uint32_t)attr.cb_mem + osRtxMessageQueueCbSize + cb_mem_pad);
-        }
-
-        if (attr.cb_mem == NULL)
+        void* mem = malloc(CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize));
+        if (mem == NULL)
         {
             status = CY_RTOS_NO_MEMORY;
         }
         else
         {
-            CY_ASSERT(((uint32_t)attr.cb_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
-            CY_ASSERT(((uint32_t)attr.mq_mem & CY_RTOS_ALIGNMENT_MASK) == 0UL);
-            *queue = osMessageQueueNew(length, itemsize, &attr);
-            CY_ASSERT((*queue == attr.cb_mem) || (*queue == NULL));
-            status = (*queue == NULL) ? CY_RTOS_GENERAL_ERROR : CY_RSLT_SUCCESS;
+            status = queue_start(queue, length, itemsize, mem, 0U);
         }
     }
 
@@ -901,6 +979,31 @@ cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_init_static(cy_queue_t* queue, size_t length, size_t itemsize,
+                                    void* storage)
+{
+    cy_rslt_t status;
+
+    if ((queue == NULL) || (storage == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if (0 != (((uint32_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        status = queue_start(queue, length, itemsize, storage, CY_RTOS_STATIC_IDENT);
+    }
+
+    return status;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_put
 //--------------------------------------------------------------------------------------------------
@@ -965,6 +1068,152 @@ cy_rslt_t cy_rtos_queue_get(cy_queue_t* queue, void* item_ptr, cy_time_t timeout
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// queue_put_available
+//
+// Puts items stored back to back in a queue, without waiting, until one does not fit. Returns
+// the index after the last item put.
+//--------------------------------------------------------------------------------------------------
+static size_t queue_put_available(osMessageQueueId_t queue, const uint8_t* items,
+                                  size_t itemsize, size_t first, size_t num_items)
+{
+    size_t count = first;
+    while ((count < num_items) &&
+           (osMessageQueuePut(queue, &items[count * itemsize], 0u, 0u) == osOK))
+    {
+        count++;
+    }
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// queue_get_available
+//
+// Gets items from a queue into memory for items stored back to back, without waiting, until it
+// is empty. Returns the index after the last item taken.
+//--------------------------------------------------------------------------------------------------
+static size_t queue_get_available(osMessageQueueId_t queue, uint8_t* items, size_t itemsize,
+                                  size_t first, size_t num_items)
+{
+    size_t count = first;
+    while ((count < num_items) &&
+           (osMessageQueueGet(queue, &items[count * itemsize], NULL, 0u) == osOK))
+    {
+        count++;
+    }
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_put_n
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_put_n(cy_queue_t* queue, const void* items, size_t itemsize,
+                              size_t num_items, size_t* num_put, cy_time_t timeout_ms)
+{
+    cy_rslt_t status;
+    bool      in_isr = is_in_isr();
+
+    if ((queue == NULL) || (items == NULL) || (num_items == 0) || (num_put == NULL) ||
+        (itemsize != osMessageQueueGetMsgSize(*queue)))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    // Not allowed to be called in ISR if timeout != 0
+    else if (in_isr && (timeout_ms != 0U))
+    {
+        dbgErr = osErrorISR;
+        status = CY_RTOS_GENERAL_ERROR;
+    }
+    else
+    {
+        const uint8_t* bytes = (const uint8_t*)items;
+        size_t         count;
+        if (in_isr)
+        {
+            // Threads woken from an ISR are dispatched once the ISR returns
+            count = queue_put_available(*queue, bytes, itemsize, 0, num_items);
+        }
+        else
+        {
+            // Threads woken by the items are only dispatched once the kernel is unlocked
+            int32_t lock = osKernelLock();
+            count = queue_put_available(*queue, bytes, itemsize, 0, num_items);
+            (void)osKernelRestoreLock(lock);
+
+            // Only the first item waits for space, the rest are put the same way as above
+            if ((count == 0) && (timeout_ms != 0U) &&
+                (osMessageQueuePut(*queue, bytes, 0u, timeout_ms) == osOK))
+            {
+                lock  = osKernelLock();
+                count = queue_put_available(*queue, bytes, itemsize, 1, num_items);
+                (void)osKernelRestoreLock(lock);
+            }
+        }
+
+        *num_put = count;
+        status   = (count == 0) ? CY_RTOS_QUEUE_FULL : CY_RSLT_SUCCESS;
+    }
+
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_get_n
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_get_n(cy_queue_t* queue, void* items, size_t itemsize,
+                              size_t num_items, size_t* num_got, cy_time_t timeout_ms)
+{
+    cy_rslt_t status;
+    bool      in_isr = is_in_isr();
+
+    if ((queue == NULL) || (items == NULL) || (num_items == 0) || (num_got == NULL) ||
+        (itemsize != osMessageQueueGetMsgSize(*queue)))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    // Not allowed to be called in ISR if timeout != 0
+    else if (in_isr && (timeout_ms != 0U))
+    {
+        dbgErr = osErrorISR;
+        status = CY_RTOS_GENERAL_ERROR;
+    }
+    else
+    {
+        uint8_t* bytes = (uint8_t*)items;
+        size_t   count;
+        if (in_isr)
+        {
+            // Threads woken from an ISR are dispatched once the ISR returns
+            count = queue_get_available(*queue, bytes, itemsize, 0, num_items);
+        }
+        else
+        {
+            // Threads waiting for space are only dispatched once the kernel is unlocked
+            int32_t lock = osKernelLock();
+            count = queue_get_available(*queue, bytes, itemsize, 0, num_items);
+            (void)osKernelRestoreLock(lock);
+
+            // Only the first item is waited for, the rest are taken the same way as above
+            if ((count == 0) && (timeout_ms != 0U) &&
+                (osMessageQueueGet(*queue, bytes, NULL, timeout_ms) == osOK))
+            {
+                lock  = osKernelLock();
+                count = queue_get_available(*queue, bytes, itemsize, 1, num_items);
+                (void)osKernelRestoreLock(lock);
+            }
+        }
+
+        *num_got = count;
+        status   = (count == 0) ? CY_RTOS_QUEUE_EMPTY : CY_RSLT_SUCCESS;
+    }
+
+    return status;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_count
 //--------------------------------------------------------------------------------------------------
@@ -1046,7 +1295,10 @@ cy_rslt_t cy_rtos_queue_deinit(cy_queue_t* queue)
 
         if (status == CY_RSLT_SUCCESS)
         {
-            free(*queue);
+            if (*(uint32_t*)((uint32_t)*queue + osRtxMessageQueueCbSize) != CY_RTOS_STATIC_IDENT)
+            {
+                free(*queue);
+            }
             *queue = NULL;
         }
     }
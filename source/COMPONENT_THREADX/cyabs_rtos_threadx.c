@@ -35,6 +35,7 @@
 #endif
 
 #define WRAPPER_IDENT           (0xABCDEF01U)
+#define WRAPPER_IDENT_STATIC    (0xABCDEF02U)
 #define MAX_QUEUE_MESSAGE_SIZE  (16)
 #define ALL_EVENT_FLAGS         (0xFFFFFFFFU)
 #define MILLISECONDS_PER_SECOND (1000)
@@ -115,12 +116,7 @@ cy_rtos_error_t cy_rtos_last_error(void)
 *                 Threads
 ******************************************************/
 
-typedef struct
-{
-    TX_THREAD thread;
-    uint32_t  magic;
-    void*     memptr;
-} cy_thread_wrapper_t;
+typedef cy_thread_cb_t cy_thread_wrapper_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -185,6 +181,40 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_create_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_create_static(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
+                                       const char* name, void* stack, uint32_t stack_size,
+                                       cy_thread_priority_t priority, cy_thread_arg_t arg,
+                                       cy_thread_cb_t* cb)
+{
+    stack_size &= ~CY_RTOS_ALIGNMENT_MASK; // make stack pointer 8-byte aligned
+    if ((thread == NULL) || (stack == NULL) || (cb == NULL) ||
+        (stack_size < CY_RTOS_MIN_STACK_SIZE))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    if ((0 != (((uint32_t)stack) & CY_RTOS_ALIGNMENT_MASK)) ||
+        (0 != (((uint32_t)cb) & CY_RTOS_ALIGNMENT_MASK)))
+    {
+        return CY_RTOS_ALIGNMENT_ERROR;
+    }
+
+    // The memory belongs to the caller, so join must not free it
+    cb->magic  = WRAPPER_IDENT_STATIC;
+    cb->memptr = NULL;
+
+    *thread = (cy_thread_t)cb;
+
+    // Disable preemption-thresholding and time slicing
+    return convert_error(tx_thread_create(*thread, (CHAR*)name, entry_function, arg, stack,
+                                          stack_size, priority, priority, TX_NO_TIME_SLICE,
+                                          TX_AUTO_START));
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_thread_exit
 //--------------------------------------------------------------------------------------------------
@@ -768,14 +798,10 @@ cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
     }
 
     // round message words to next power of 2 times word size.
-    UINT message_words = 1;
-    while (message_words * BYTES_PER_QUEUE_WORD < itemsize)
-    {
-        message_words <<= 1;
-    }
+    UINT message_words = CY_RTOS_QUEUE_MESSAGE_WORDS(itemsize);
 
     queue->itemsize = itemsize;
-    ULONG queue_size = length * message_words * BYTES_PER_QUEUE_WORD;
+    ULONG queue_size = CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize);
     queue->mem = malloc(queue_size);
     if (queue->mem == NULL)
     {
@@ -795,6 +821,33 @@ cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_init_static(cy_queue_t* queue, size_t length, size_t itemsize,
+                                    void* storage)
+{
+    if ((queue == NULL) || (storage == NULL) || (itemsize == 0) ||
+        (itemsize > sizeof(ULONG) * MAX_QUEUE_MESSAGE_SIZE))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    if (0 != (((uint32_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        return CY_RTOS_ALIGNMENT_ERROR;
+    }
+
+    // The memory belongs to the caller, so deinit must not free it
+    queue->itemsize = itemsize;
+    queue->mem      = NULL;
+
+    return convert_error(tx_queue_create(&(queue->tx_queue), TX_NULL,
+                                         CY_RTOS_QUEUE_MESSAGE_WORDS(itemsize), storage,
+                                         CY_RTOS_QUEUE_STORAGE_SIZE(length, itemsize)));
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_put
 //--------------------------------------------------------------------------------------------------
@@ -829,15 +882,24 @@ cy_rslt_t cy_rtos_queue_get(cy_queue_t* queue, void* item_ptr, cy_time_t timeout
         return CY_RTOS_BAD_PARAM;
     }
 
+    // Messages that fill whole words exactly are received in place, others are bounced through
+    // buffer so that the padding of the message does not overrun the item
+    bool direct = ((queue->itemsize ==
+                    CY_RTOS_QUEUE_MESSAGE_WORDS(queue->itemsize) * sizeof(ULONG)) &&
+                   ((((uintptr_t)item_ptr) & (sizeof(ULONG) - 1U)) == 0U));
     cy_rtos_error_t tx_rslt =
-        tx_queue_receive(&(queue->tx_queue), buffer, convert_ms_to_ticks(timeout_ms));
+        tx_queue_receive(&(queue->tx_queue), direct ? item_ptr : (void*)buffer,
+                         convert_ms_to_ticks(timeout_ms));
     if (TX_QUEUE_EMPTY == tx_rslt)
     {
         return CY_RTOS_TIMEOUT;
     }
     else if (tx_rslt == TX_SUCCESS)
     {
-        memcpy(item_ptr, (void*)buffer, queue->itemsize);
+        if (!direct)
+        {
+            memcpy(item_ptr, (void*)buffer, queue->itemsize);
+        }
         return CY_RSLT_SUCCESS;
     }
     else
@@ -848,6 +910,171 @@ cy_rslt_t cy_rtos_queue_get(cy_queue_t* queue, void* item_ptr, cy_time_t timeout
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// queue_lock
+//
+// Keeps the calling thread from being preempted, so threads woken by a batch of queue operations
+// are switched to once, when queue_unlock is called. Returns the previous preemption threshold.
+//--------------------------------------------------------------------------------------------------
+static UINT queue_lock(TX_THREAD* thread)
+{
+    UINT old_threshold = 0;
+    if (thread != TX_NULL)
+    {
+        (void)tx_thread_preemption_change(thread, 0, &old_threshold);
+    }
+    return old_threshold;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// queue_unlock
+//--------------------------------------------------------------------------------------------------
+static void queue_unlock(TX_THREAD* thread, UINT old_threshold)
+{
+    if (thread != TX_NULL)
+    {
+        (void)tx_thread_preemption_change(thread, old_threshold, &old_threshold);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// queue_put_available
+//
+// Puts items stored back to back in a queue, without waiting, until one does not fit. Returns
+// the index after the last item put.
+//--------------------------------------------------------------------------------------------------
+static size_t queue_put_available(cy_queue_t* queue, const uint8_t* items, size_t first,
+                                  size_t num_items)
+{
+    // Each message is a whole number of words, which may be more than one item
+    ULONG  buffer[MAX_QUEUE_MESSAGE_SIZE];
+    size_t count = first;
+    while (count < num_items)
+    {
+        memcpy(buffer, &items[count * queue->itemsize], queue->itemsize);
+        if (tx_queue_send(&(queue->tx_queue), buffer, TX_NO_WAIT) != TX_SUCCESS)
+        {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// queue_get_available
+//
+// Gets items from a queue into memory for items stored back to back, without waiting, until it
+// is empty. Returns the index after the last item taken.
+//--------------------------------------------------------------------------------------------------
+static size_t queue_get_available(cy_queue_t* queue, uint8_t* items, size_t first,
+                                  size_t num_items)
+{
+    // Same as cy_rtos_queue_get, items that fill whole messages are received in place
+    ULONG  buffer[MAX_QUEUE_MESSAGE_SIZE];
+    bool   direct = ((queue->itemsize ==
+                      CY_RTOS_QUEUE_MESSAGE_WORDS(queue->itemsize) * sizeof(ULONG)) &&
+                     ((((uintptr_t)items) & (sizeof(ULONG) - 1U)) == 0U));
+    size_t count = first;
+    while (count < num_items)
+    {
+        uint8_t* item = &items[count * queue->itemsize];
+        if (tx_queue_receive(&(queue->tx_queue), direct ? (void*)item : (void*)buffer,
+                             TX_NO_WAIT) != TX_SUCCESS)
+        {
+            break;
+        }
+        if (!direct)
+        {
+            memcpy(item, buffer, queue->itemsize);
+        }
+        count++;
+    }
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_put_n
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_put_n(cy_queue_t* queue, const void* items, size_t itemsize,
+                              size_t num_items, size_t* num_put, cy_time_t timeout_ms)
+{
+    bool in_isr = is_in_isr();
+    if ((queue == NULL) || (items == NULL) || (itemsize != queue->itemsize) ||
+        (num_items == 0) || (num_put == NULL) || (in_isr && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    // Threads woken from an ISR are only scheduled once the ISR returns
+    TX_THREAD*     thread = in_isr ? TX_NULL : tx_thread_identify();
+    const uint8_t* bytes  = (const uint8_t*)items;
+    UINT           old    = queue_lock(thread);
+    size_t         count  = queue_put_available(queue, bytes, 0, num_items);
+    queue_unlock(thread, old);
+
+    // Only the first item waits for space, the rest are put the same way as above
+    if ((count == 0) && (timeout_ms != 0))
+    {
+        ULONG buffer[MAX_QUEUE_MESSAGE_SIZE];
+        memcpy(buffer, bytes, itemsize);
+        if (tx_queue_send(&(queue->tx_queue), buffer, convert_ms_to_ticks(timeout_ms)) ==
+            TX_SUCCESS)
+        {
+            old   = queue_lock(thread);
+            count = queue_put_available(queue, bytes, 1, num_items);
+            queue_unlock(thread, old);
+        }
+    }
+
+    *num_put = count;
+    return (count == 0) ? CY_RTOS_QUEUE_FULL : CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_get_n
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_get_n(cy_queue_t* queue, void* items, size_t itemsize,
+                              size_t num_items, size_t* num_got, cy_time_t timeout_ms)
+{
+    bool in_isr = is_in_isr();
+    if ((queue == NULL) || (items == NULL) || (itemsize != queue->itemsize) ||
+        (num_items == 0) || (num_got == NULL) || (in_isr && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    // Threads woken from an ISR are only scheduled once the ISR returns
+    TX_THREAD* thread = in_isr ? TX_NULL : tx_thread_identify();
+    uint8_t*   bytes  = (uint8_t*)items;
+    UINT       old    = queue_lock(thread);
+    size_t     count  = queue_get_available(queue, bytes, 0, num_items);
+    queue_unlock(thread, old);
+
+    // Only the first item is waited for, the rest are taken the same way as above
+    if ((count == 0) && (timeout_ms != 0))
+    {
+        ULONG buffer[MAX_QUEUE_MESSAGE_SIZE];
+        if (tx_queue_receive(&(queue->tx_queue), buffer, convert_ms_to_ticks(timeout_ms)) ==
+            TX_SUCCESS)
+        {
+            memcpy(bytes, buffer, itemsize);
+            old   = queue_lock(thread);
+            count = queue_get_available(queue, bytes, 1, num_items);
+            queue_unlock(thread, old);
+        }
+    }
+
+    *num_got = count;
+    return (count == 0) ? CY_RTOS_QUEUE_EMPTY : CY_RSLT_SUCCESS;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_count
 //--------------------------------------------------------------------------------------------------
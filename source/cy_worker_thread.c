@@ -39,189 +39,3540 @@
 #define cyhal_system_critical_section_exit(x) mtb_hal_system_critical_section_exit(x)
 #endif
 
+// Flag in enqueue_count that refuses new enqueue requests while the worker is not running
+#define CY_WORKER_THREAD_CLOSED     (0x80000000U)
+
+#if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+// Flag in cy_worker_tombstone_t::lanes while a cancel fills the tombstone in
+#define CY_WORKER_TOMBSTONE_CLAIMED (0x80000000U)
+#endif
+
+#if defined(CY_WORKER_THREAD_ENABLE_STATS)
+// Adds delta to a counter of cy_worker_thread_stats_t
+#define CY_WORKER_STATS_ADD(worker, counter, delta) \
+    ((void)cy_rtos_atomic_add(&(worker)->stats.counter, (delta)))
+#else
+#define CY_WORKER_STATS_ADD(worker, counter, delta) ((void)(delta))
+#endif
+
+// Flags in cy_worker_completion_t::state
+#define CY_WORKER_COMPLETION_DONE       (1U << 0)
+#define CY_WORKER_COMPLETION_WAITING    (1U << 1)
+
+// Flags in cy_worker_periodic_t::state
+#define CY_WORKER_PERIODIC_SCHEDULED    (1U << 0)   // Linked into the worker's list or running
+#define CY_WORKER_PERIODIC_LINKED       (1U << 1)
+#define CY_WORKER_PERIODIC_STOPPED      (1U << 2)   // Not scheduled again once the run ends
+
 #if defined(__cplusplus)
 extern "C"
 {
 #endif
 
-// Info for dispatching a function call
+// Thread blocked in cy_worker_thread_flush or cy_worker_thread_pause, lives on its stack
+typedef struct cy_worker_waiter
+{
+    struct cy_worker_waiter* next;
+    cy_thread_t              thread;
+    uint32_t                 seq;       // Flush to wait for, or 0 to wait for the worker to pause
+    volatile bool            released;  // Set once the worker no longer references the waiter
+} cy_worker_waiter_t;
+
+// Entry of the queues of a worker. Only the first entry_size bytes are queued, so the payload
+// takes no queue memory unless the worker was created with a payload size.
 typedef struct
 {
-    cy_worker_thread_func_t* work_func;
-    void*                    arg;
-} cy_worker_dispatch_info_t;
+    cy_worker_dispatch_info_t dispatch_info;
+    #if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+    uint32_t                  epoch;    // Cancel epoch when the work was queued
+    #endif
+    uint32_t                  payload[(CY_WORKER_THREAD_MAX_PAYLOAD + 3) / 4];
+} cy_worker_entry_t;
+
+// Its address is the arg of work queued with a payload, which is replaced by the payload copy
+static uint8_t cy_worker_payload_tag;
 
 
 //--------------------------------------------------------------------------------------------------
-// cy_worker_thread_func
+// cy_worker_thread_wakeup
 //
-/* Worker Thread to dispatch the events that added to the event queue.
- * It will wait indefinitely for a item to be queued and will terminate
- * when the NULL work function is queued by delete. It will process all
- * events before the terminating event.
- * @param   arg : pointer to @ref cy_worker_thread_info_t
+/* Placeholder work queued on the lowest lane to wake a worker that is blocked waiting for work
+ * after work was queued on a higher lane.
+ * @param   arg : unused
  */
 //--------------------------------------------------------------------------------------------------
-static void cy_worker_thread_func(cy_thread_arg_t arg)
+static void cy_worker_thread_wakeup(void* arg)
 {
-    cy_rslt_t                 result;
-    cy_worker_dispatch_info_t dispatch_info;
-    cy_worker_thread_info_t*  worker = (cy_worker_thread_info_t*)arg;
+    CY_UNUSED_PARAMETER(arg);
+}
 
-    while (1)
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_flush_marker
+//
+/* Placeholder work queued by @ref cy_worker_thread_flush. The worker recognizes it and records
+ * that all work queued before it has run.
+ * @param   arg : flush sequence number
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_flush_marker(void* arg)
+{
+    CY_UNUSED_PARAMETER(arg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_entry_set_epoch
+//
+/* Records the current cancel epoch in an entry that is about to be queued, so that only cancels
+ * issued before it can drop it.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   entry  : entry to stamp
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void cy_worker_entry_set_epoch(const cy_worker_thread_info_t* worker,
+                                             cy_worker_entry_t* entry)
+{
+    #if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+    entry->epoch = worker->cancel_epoch;
+    #else
+    CY_UNUSED_PARAMETER(worker);
+    CY_UNUSED_PARAMETER(entry);
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_waiter_ready
+//
+/* Checks whether the condition a waiter is blocked on has been reached. Must be called from
+ * within a critical section.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   seq    : flush sequence number, or 0 for a pause
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_worker_waiter_ready(const cy_worker_thread_info_t* worker, uint32_t seq)
+{
+    return (seq == 0)
+        ? (worker->parked != 0)
+        : ((int32_t)(worker->flushed - seq) >= 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_release_waiters
+//
+/* Wakes the threads waiting in @ref cy_worker_thread_flush or @ref cy_worker_thread_pause whose
+ * condition has been reached. Each waiter is unlinked and released inside a critical section
+ * and only its copied thread handle is used afterwards, so the waiter may return as soon as it
+ * sees that it was released.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_release_waiters(cy_worker_thread_info_t* worker)
+{
+    while (worker->waiters != NULL)
     {
-        result = cy_rtos_queue_get(&worker->event_queue, &dispatch_info, CY_RTOS_NEVER_TIMEOUT);
-        if (result == CY_RSLT_SUCCESS)
+        cy_thread_t          thread = NULL;
+        uint32_t             state  = cyhal_system_critical_section_enter();
+        cy_worker_waiter_t** link   = (cy_worker_waiter_t**)&worker->waiters;
+        while ((*link != NULL) && !cy_worker_waiter_ready(worker, (*link)->seq))
         {
-            if (dispatch_info.work_func != NULL)
-            {
-                dispatch_info.work_func(dispatch_info.arg);
-            }
-            else
-            {
-                break;
-            }
+            link = &(*link)->next;
         }
+        cy_worker_waiter_t* waiter = *link;
+        if (waiter != NULL)
+        {
+            *link            = waiter->next;
+            thread           = waiter->thread;
+            waiter->released = true;
+        }
+        cyhal_system_critical_section_exit(state);
+
+        if (waiter == NULL)
+        {
+            break;
+        }
+        (void)cy_rtos_thread_set_notification(&thread);
     }
-    cy_rtos_thread_exit();
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// cy_worker_thread_create
+// cy_worker_thread_wait
+//
+/* Blocks the calling thread until a flush has completed or the worker has paused.
+ * @param   worker     : pointer to @ref cy_worker_thread_info_t
+ * @param   seq        : flush sequence number to wait for, or 0 to wait for the worker to pause
+ * @param   timeout_ms : maximum time to wait
+ */
 //--------------------------------------------------------------------------------------------------
-cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
-                                  const cy_worker_thread_params_t* params)
+static cy_rslt_t cy_worker_thread_wait(cy_worker_thread_info_t* worker, uint32_t seq,
+                                       cy_time_t timeout_ms)
 {
-    // Param check
-    CY_ASSERT((params != NULL) && (new_worker != NULL));
-    CY_ASSERT((params->stack == NULL) || ((params->stack != NULL) && (params->stack_size != 0)));
+    cy_worker_waiter_t waiter = { NULL, NULL, seq, false };
+    cy_rslt_t          result = cy_rtos_thread_get_handle(&waiter.thread);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
 
-    // Start with a clean structure
-    memset(new_worker, 0, sizeof(cy_worker_thread_info_t));
+    uint32_t state = cyhal_system_critical_section_enter();
+    if (cy_worker_waiter_ready(worker, seq))
+    {
+        cyhal_system_critical_section_exit(state);
+        return CY_RSLT_SUCCESS;
+    }
+    waiter.next     = (cy_worker_waiter_t*)worker->waiters;
+    worker->waiters = &waiter;
+    cyhal_system_critical_section_exit(state);
 
-    cy_rslt_t result = cy_rtos_queue_init(&new_worker->event_queue,
-                                          (params->num_entries != 0)
-                                          ? params->num_entries
-                                          : CY_WORKER_DEFAULT_ENTRIES,
-                                          sizeof(cy_worker_dispatch_info_t));
-    if (result == CY_RSLT_SUCCESS)
+    cy_time_t start;
+    cy_rtos_time_get(&start);
+    cy_time_t remaining = timeout_ms;
+    while (!waiter.released)
     {
-        new_worker->state = CY_WORKER_THREAD_VALID;
-        result            = cy_rtos_thread_create(&new_worker->thread,
-                                                  cy_worker_thread_func,
-                                                  (params->name != NULL)
-                                                  ? params->name
-                                                  : CY_WORKER_THREAD_DEFAULT_NAME,
-                                                  params->stack,
-                                                  params->stack_size,
-                                                  params->priority,
-                                                  (cy_thread_arg_t)new_worker);
+        // Other uses of the thread notification can wake the thread early
+        (void)cy_rtos_thread_wait_notification(remaining);
+        if ((timeout_ms != CY_RTOS_NEVER_TIMEOUT) && !waiter.released)
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            cy_time_t elapsed = now - start;
+            if (elapsed >= timeout_ms)
+            {
+                break;
+            }
+            remaining = timeout_ms - elapsed;
+        }
+    }
 
-        if (result != CY_RSLT_SUCCESS)
+    state = cyhal_system_critical_section_enter();
+    if (!waiter.released)
+    {
+        cy_worker_waiter_t** link = (cy_worker_waiter_t**)&worker->waiters;
+        while (*link != &waiter)
         {
-            new_worker->state = CY_WORKER_THREAD_INVALID;
-            cy_rtos_queue_deinit(&new_worker->event_queue);
+            link = &(*link)->next;
         }
+        *link  = waiter.next;
+        result = CY_RTOS_TIMEOUT;
     }
+    cyhal_system_critical_section_exit(state);
     return result;
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// cy_worker_thread_delete
+// cy_worker_thread_check_pause
+//
+/* Parks the calling worker thread while the worker is paused.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
 //--------------------------------------------------------------------------------------------------
-cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker)
+static void cy_worker_thread_check_pause(cy_worker_thread_info_t* worker)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
+    if (worker->paused == 0)
+    {
+        return;
+    }
 
-    uint32_t state = cyhal_system_critical_section_enter();
-    if (old_worker->state != CY_WORKER_THREAD_INVALID)
+    (void)cy_rtos_atomic_add(&worker->parked, 1);
+    cy_worker_thread_release_waiters(worker);
+    while (worker->paused != 0)
     {
-        // Don't allow terminating while cy_rtos_put_queue is running
-        if (old_worker->state == CY_WORKER_THREAD_VALID)
+        (void)cy_rtos_thread_wait_notification(CY_RTOS_NEVER_TIMEOUT);
+    }
+    (void)cy_rtos_atomic_add(&worker->parked, (uint32_t)-1);
+}
+
+
+#if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_retire
+//
+/* Records that a lane holds no more work cancelled by a tombstone. Only the worker thread
+ * retires tombstones, after it has checked every entry it took from the lane against them.
+ * @param   tombstone : tombstone to update
+ * @param   lane      : lane that was passed
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_retire(cy_worker_tombstone_t* tombstone, uint32_t lane)
+{
+    uint32_t lanes;
+    do
+    {
+        lanes = tombstone->lanes;
+    } while (!cy_rtos_atomic_cas(&tombstone->lanes, lanes, lanes & ~(1U << lane)));
+}
+
+
+#endif // (CY_WORKER_THREAD_MAX_CANCEL > 0)
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_retire_idle
+//
+/* Retires the tombstones of the lanes that are empty, called by the worker thread before it
+ * blocks waiting for work.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_retire_idle(cy_worker_thread_info_t* worker)
+{
+    #if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+    for (uint32_t i = 0; i < CY_WORKER_THREAD_MAX_CANCEL; i++)
+    {
+        cy_worker_tombstone_t* tombstone = &worker->tombstones[i];
+        for (uint32_t lane = 0; lane < worker->num_lanes; lane++)
         {
-            // A terminating event is queued that will break the while loop
-            // Note that this is ok because thread enqueue function will not
-            // allow NULL as a valid value for the work function.
-            old_worker->state = CY_WORKER_THREAD_TERMINATING;
-            cyhal_system_critical_section_exit(state);
-            cy_worker_dispatch_info_t dispatch_info = { NULL, NULL };
-            result = cy_rtos_queue_put(&old_worker->event_queue, &dispatch_info, 0);
-            if (result != CY_RSLT_SUCCESS)
+            cy_queue_t* queue =
+                (lane == 0) ? &worker->event_queue : &worker->lane_queues[lane - 1];
+            size_t      count;
+            if (((tombstone->lanes & (1U << lane)) != 0) &&
+                (cy_rtos_queue_count(queue, &count) == CY_RSLT_SUCCESS) && (count == 0))
             {
-                // Could not enqueue termination task, return to valid state
-                state = cyhal_system_critical_section_enter();
-                old_worker->state = CY_WORKER_THREAD_VALID;
-                cyhal_system_critical_section_exit(state);
-
-                return result;
+                cy_worker_thread_retire(tombstone, lane);
             }
         }
+    }
+    #else
+    CY_UNUSED_PARAMETER(worker);
+    #endif
+}
 
-        if (old_worker->state != CY_WORKER_THREAD_JOIN_COMPLETE)
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_skip
+//
+/* Checks work the worker thread just took from a lane against the tombstones. Work queued
+ * after a cancel shows that the lane holds no more work cancelled by it.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   lane   : lane the work was taken from
+ * @param   entry  : work taken
+ * @return  true if the work was cancelled and must be dropped
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_skip(cy_worker_thread_info_t* worker, uint32_t lane,
+                                  const cy_worker_entry_t* entry)
+{
+    bool skip = false;
+    #if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+    for (uint32_t i = 0; i < CY_WORKER_THREAD_MAX_CANCEL; i++)
+    {
+        cy_worker_tombstone_t* tombstone = &worker->tombstones[i];
+        if ((tombstone->lanes & (1U << lane)) == 0)
         {
-            cyhal_system_critical_section_exit(state);
-            result = cy_rtos_thread_join(&old_worker->thread);
-            if (result != CY_RSLT_SUCCESS)
+            continue;
+        }
+        // The tombstone was filled in before its lanes were set
+        cy_rtos_memory_barrier();
+        if ((int32_t)(entry->epoch - tombstone->epoch) > 0)
+        {
+            cy_worker_thread_retire(tombstone, lane);
+        }
+        else if ((entry->dispatch_info.work_func == tombstone->work_func) &&
+                 (entry->dispatch_info.arg == tombstone->arg))
+        {
+            skip = true;
+        }
+    }
+    if (skip)
+    {
+        CY_WORKER_STATS_ADD(worker, cancelled, 1);
+    }
+    #else
+    CY_UNUSED_PARAMETER(worker);
+    CY_UNUSED_PARAMETER(lane);
+    CY_UNUSED_PARAMETER(entry);
+    #endif
+    return skip;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_lane
+//
+/* Takes the oldest work from the highest priority lane above lane 0 that has work queued.
+ * Cancelled work is dropped.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   entry  : receives the work
+ * @return  true if work was taken, false if lanes 1 and up are empty
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_get_lane(cy_worker_thread_info_t* worker, cy_worker_entry_t* entry)
+{
+    // The higher lanes are only polled while work is known to be queued on them
+    for (uint32_t lane = worker->num_lanes - 1; (lane > 0) && (worker->lane_pending != 0); lane--)
+    {
+        while (cy_rtos_queue_get(&worker->lane_queues[lane - 1], entry, 0) == CY_RSLT_SUCCESS)
+        {
+            (void)cy_rtos_atomic_add(&worker->lane_pending, (uint32_t)-1);
+            if (!cy_worker_thread_skip(worker, lane, entry))
             {
-                return result;
+                return true;
             }
-            state = cyhal_system_critical_section_enter();
-            old_worker->state = CY_WORKER_THREAD_JOIN_COMPLETE;
         }
+    }
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_time_before
+//
+/* Compares two RTOS times, taking wrap-around into account.
+ * @return  true if time a is earlier than time b
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_worker_time_before(cy_time_t a, cy_time_t b)
+{
+    return ((int32_t)(a - b) < 0);
+}
+
 
-        if (old_worker->state != CY_WORKER_THREAD_INVALID)
+//--------------------------------------------------------------------------------------------------
+// cy_worker_heap_push
+//
+/* Adds an entry to a binary min-heap ordered by time. Must be called from within a critical
+ * section.
+ * @param   heap  : heap storage
+ * @param   count : number of entries in the heap, updated on success
+ * @param   size  : capacity of the heap storage
+ * @param   entry : entry to add
+ * @return  true if the entry was added, false if the heap is full
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_heap_push(cy_worker_timed_info_t* heap, uint32_t* count, uint32_t size,
+                                const cy_worker_timed_info_t* entry)
+{
+    if (*count == size)
+    {
+        return false;
+    }
+    uint32_t index = (*count)++;
+    while (index > 0)
+    {
+        uint32_t parent = (index - 1) / 2;
+        if (!cy_worker_time_before(entry->time, heap[parent].time))
         {
-            cyhal_system_critical_section_exit(state);
-            result = cy_rtos_queue_deinit(&old_worker->event_queue);
-            if (result != CY_RSLT_SUCCESS)
+            break;
+        }
+        heap[index] = heap[parent];
+        index       = parent;
+    }
+    heap[index] = *entry;
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_heap_pop
+//
+/* Removes the earliest entry from a non-empty binary min-heap. Must be called from within a
+ * critical section.
+ * @param   heap  : heap storage
+ * @param   count : number of entries in the heap, updated on return
+ * @param   entry : receives the removed entry
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_heap_pop(cy_worker_timed_info_t* heap, uint32_t* count,
+                               cy_worker_timed_info_t* entry)
+{
+    *entry = heap[0];
+    cy_worker_timed_info_t* last = &heap[--(*count)];
+    uint32_t                index = 0;
+    while (1)
+    {
+        uint32_t child = (2 * index) + 1;
+        if (child >= *count)
+        {
+            break;
+        }
+        if (((child + 1) < *count) && cy_worker_time_before(heap[child + 1].time, heap[child].time))
+        {
+            child++;
+        }
+        if (!cy_worker_time_before(heap[child].time, last->time))
+        {
+            break;
+        }
+        heap[index] = heap[child];
+        index       = child;
+    }
+    heap[index] = *last;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_expired
+//
+/* Takes the earliest delayed work if it has expired.
+ * @param   worker        : pointer to @ref cy_worker_thread_info_t
+ * @param   dispatch_info : receives the work
+ * @param   timeout_ms    : receives how long the worker may wait for new work before the
+ *                          earliest delayed work expires
+ * @return  true if expired work was taken
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_get_expired(cy_worker_thread_info_t* worker,
+                                         cy_worker_dispatch_info_t* dispatch_info,
+                                         cy_time_t* timeout_ms)
+{
+    bool expired = false;
+    *timeout_ms = CY_RTOS_NEVER_TIMEOUT;
+    if (worker->delayed_count != 0)
+    {
+        cy_time_t now;
+        cy_rtos_time_get(&now);
+
+        cy_worker_timed_info_t* heap  = (cy_worker_timed_info_t*)worker->delayed;
+        uint32_t                state = cyhal_system_critical_section_enter();
+        if (worker->delayed_count != 0)
+        {
+            if (cy_worker_time_before(now, heap[0].time))
             {
-                return result;
+                *timeout_ms = heap[0].time - now;
+            }
+            else
+            {
+                cy_worker_timed_info_t entry;
+                cy_worker_heap_pop(heap, &worker->delayed_count, &entry);
+                *dispatch_info = entry.dispatch_info;
+                #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+                dispatch_info->time = entry.time;
+                #endif
+                expired = true;
             }
-            state = cyhal_system_critical_section_enter();
-            old_worker->state = CY_WORKER_THREAD_INVALID;
         }
+        cyhal_system_critical_section_exit(state);
     }
+    return expired;
+}
 
-    cyhal_system_critical_section_exit(state);
-    return result;
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_periodic_link
+//
+/* Links periodic work into the worker's list, which is ordered by due time. Work due at the
+ * same time runs in the order it was linked. Must be called from within a critical section.
+ * @param   worker   : pointer to @ref cy_worker_thread_info_t
+ * @param   periodic : work to link
+ * @return  true if the work was linked at the head of the list
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_periodic_link(cy_worker_thread_info_t* worker,
+                                    cy_worker_periodic_t* periodic)
+{
+    cy_worker_periodic_t** link = &worker->periodic;
+    while ((*link != NULL) && !cy_worker_time_before(periodic->due, (*link)->due))
+    {
+        link = &(*link)->next;
+    }
+    periodic->next   = *link;
+    *link            = periodic;
+    periodic->state |= CY_WORKER_PERIODIC_LINKED;
+    return (link == &worker->periodic);
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// cy_worker_thread_enqueue
+// cy_worker_periodic_run
+//
+/* Runs periodic work and schedules the next run one period after this one was due, skipping
+ * runs that are already overdue, unless the work was stopped meanwhile.
+ * @param   arg : pointer to @ref cy_worker_periodic_t
+ */
 //--------------------------------------------------------------------------------------------------
-cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
-                                   cy_worker_thread_func_t* work_func, void* arg)
+static void cy_worker_periodic_run(void* arg)
 {
-    CY_ASSERT(worker_info != NULL);
-    CY_ASSERT(work_func != NULL);
+    cy_worker_periodic_t*    periodic = (cy_worker_periodic_t*)arg;
+    cy_worker_thread_info_t* worker   = (cy_worker_thread_info_t*)periodic->worker;
 
+    periodic->work_func(periodic->arg);
+
+    cy_time_t now;
+    cy_rtos_time_get(&now);
     uint32_t state = cyhal_system_critical_section_enter();
-    if ((worker_info->state != CY_WORKER_THREAD_VALID) &&
-        (worker_info->state != CY_WORKER_THREAD_ENQUEUING))
+    if ((periodic->state & CY_WORKER_PERIODIC_STOPPED) != 0)
     {
-        cyhal_system_critical_section_exit(state);
-        return CY_WORKER_THREAD_ERR_THREAD_INVALID;
+        periodic->state = 0;
+    }
+    else
+    {
+        periodic->due += periodic->period_ms;
+        if (!cy_worker_time_before(now, periodic->due))
+        {
+            uint32_t skipped = ((now - periodic->due) / periodic->period_ms) + 1;
+            periodic->due      += skipped * periodic->period_ms;
+            periodic->overruns += skipped;
+        }
+        // The worker is running this, so it re-evaluates its wait without a wakeup
+        (void)cy_worker_periodic_link(worker, periodic);
     }
-    worker_info->enqueue_count++;
-    worker_info->state = CY_WORKER_THREAD_ENQUEUING;
     cyhal_system_critical_section_exit(state);
+}
 
-    cy_worker_dispatch_info_t dispatch_info = { work_func, arg };
-    // Queue an event to be run by the worker thread
-    cy_rslt_t result = cy_rtos_queue_put(&worker_info->event_queue, &dispatch_info, 0);
 
-    state = cyhal_system_critical_section_enter();
-    worker_info->enqueue_count--;
-    if (worker_info->enqueue_count == 0)
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_periodic
+//
+/* Takes the earliest periodic work if it is due.
+ * @param   worker        : pointer to @ref cy_worker_thread_info_t
+ * @param   dispatch_info : receives the work
+ * @param   timeout_ms    : shortened to when the earliest periodic work becomes due, if that
+ *                          is earlier
+ * @return  true if due work was taken
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_get_periodic(cy_worker_thread_info_t* worker,
+                                          cy_worker_dispatch_info_t* dispatch_info,
+                                          cy_time_t* timeout_ms)
+{
+    if (worker->periodic == NULL)
     {
-        worker_info->state = CY_WORKER_THREAD_VALID;
+        return false;
     }
-    cyhal_system_critical_section_exit(state);
 
-    return result;
+    cy_time_t now;
+    cy_rtos_time_get(&now);
+    bool                  due      = false;
+    uint32_t              state    = cyhal_system_critical_section_enter();
+    cy_worker_periodic_t* periodic = worker->periodic;
+    if (periodic != NULL)
+    {
+        if (cy_worker_time_before(now, periodic->due))
+        {
+            if ((cy_time_t)(periodic->due - now) < *timeout_ms)
+            {
+                *timeout_ms = periodic->due - now;
+            }
+        }
+        else
+        {
+            worker->periodic         = periodic->next;
+            periodic->state         &= ~CY_WORKER_PERIODIC_LINKED;
+            dispatch_info->work_func = cy_worker_periodic_run;
+            dispatch_info->arg       = periodic;
+            #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+            dispatch_info->time = periodic->due;
+            #endif
+            due = true;
+        }
+    }
+    cyhal_system_critical_section_exit(state);
+    return due;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_deferred
+//
+/* Takes held deferrable work if the worker is awake anyway or the slack of the oldest held work
+ * has run out. Once one item ran out of slack the worker is awake, so the others follow.
+ * @param   worker        : pointer to @ref cy_worker_thread_info_t
+ * @param   dispatch_info : receives the work
+ * @param   timeout_ms    : shortened to when the slack of the oldest held work runs out, if
+ *                          that is earlier
+ * @param   awake         : true if the worker has run other work since it last blocked
+ * @return  true if work was taken
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_get_deferred(cy_worker_thread_info_t* worker,
+                                          cy_worker_dispatch_info_t* dispatch_info,
+                                          cy_time_t* timeout_ms, bool awake)
+{
+    if (worker->deferred_count == 0)
+    {
+        return false;
+    }
+
+    cy_time_t now;
+    cy_rtos_time_get(&now);
+    bool                    taken = false;
+    cy_worker_timed_info_t* heap  = (cy_worker_timed_info_t*)worker->deferred;
+    uint32_t                state = cyhal_system_critical_section_enter();
+    if (worker->deferred_count != 0)
+    {
+        if (awake || !cy_worker_time_before(now, heap[0].time))
+        {
+            cy_worker_timed_info_t entry;
+            cy_worker_heap_pop(heap, &worker->deferred_count, &entry);
+            *dispatch_info = entry.dispatch_info;
+            taken          = true;
+        }
+        else if ((cy_time_t)(heap[0].time - now) < *timeout_ms)
+        {
+            *timeout_ms = heap[0].time - now;
+        }
+    }
+    cyhal_system_critical_section_exit(state);
+    return taken;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_deadline
+//
+/* Takes the work with the earliest deadline and counts it as missed if the deadline has
+ * already passed.
+ * @param   worker        : pointer to @ref cy_worker_thread_info_t
+ * @param   dispatch_info : receives the work
+ * @return  true if work was taken, false if no work with a deadline is pending
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_get_deadline(cy_worker_thread_info_t* worker,
+                                          cy_worker_dispatch_info_t* dispatch_info)
+{
+    if (worker->deadline_count == 0)
+    {
+        return false;
+    }
+
+    cy_worker_timed_info_t  entry;
+    bool                    taken = false;
+    cy_worker_timed_info_t* heap  = (cy_worker_timed_info_t*)worker->deadline;
+    uint32_t                state = cyhal_system_critical_section_enter();
+    if (worker->deadline_count != 0)
+    {
+        cy_worker_heap_pop(heap, &worker->deadline_count, &entry);
+        taken = true;
+    }
+    cyhal_system_critical_section_exit(state);
+
+    if (taken)
+    {
+        #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+        cy_time_t now;
+        cy_rtos_time_get(&now);
+        if (cy_worker_time_before(entry.time, now))
+        {
+            CY_WORKER_STATS_ADD(worker, missed, 1);
+        }
+        #endif
+        *dispatch_info = entry.dispatch_info;
+    }
+    return taken;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_take_items
+//
+/* Takes all pending work items from a worker.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @return  the taken items in the order they were queued, or NULL if none are pending
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_work_item_t* cy_worker_thread_take_items(cy_worker_thread_info_t* worker)
+{
+    cy_work_item_t* items;
+    do
+    {
+        items = worker->items;
+    } while ((items != NULL) &&
+             !cy_rtos_atomic_cas_ptr((void* volatile*)&worker->items, items, NULL));
+
+    // Items are pushed onto the front of the list, reverse it to run them in FIFO order
+    cy_work_item_t* fifo = NULL;
+    while (items != NULL)
+    {
+        cy_work_item_t* next = items->next;
+        items->next = fifo;
+        fifo        = items;
+        items       = next;
+    }
+    return fifo;
+}
+
+
+#if defined(CY_WORKER_THREAD_ENABLE_STATS)
+//--------------------------------------------------------------------------------------------------
+// cy_worker_stats_bucket
+//
+/* Selects the histogram bucket for a duration. Bucket 0 holds durations below 1 ms and bucket
+ * n holds durations from 2^(n-1) up to 2^n ms; the last bucket also holds anything longer.
+ * @param   duration_ms : duration to classify
+ * @return  the bucket index
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_worker_stats_bucket(cy_time_t duration_ms)
+{
+    uint32_t bucket = 0;
+    while ((duration_ms != 0) && (bucket < (CY_WORKER_THREAD_STATS_BUCKETS - 1)))
+    {
+        duration_ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+
+#endif // defined(CY_WORKER_THREAD_ENABLE_STATS)
+
+
+static void cy_worker_thread_run_items(cy_worker_thread_info_t* worker, cy_work_item_t* items);
+static void cy_worker_thread_run_deferred(cy_worker_thread_info_t* worker);
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_seq_advance
+//
+/* Moves a flush sequence number forward to seq unless it is already there or beyond.
+ * @param   seq_ptr : sequence number to update
+ * @param   seq     : flush sequence number
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_seq_advance(volatile uint32_t* seq_ptr, uint32_t seq)
+{
+    uint32_t current;
+    do
+    {
+        current = *seq_ptr;
+    } while (((int32_t)(seq - current) > 0) && !cy_rtos_atomic_cas(seq_ptr, current, seq));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_complete_flush
+//
+/* Completes a flush once all work queued before its marker has run and wakes its waiters.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   seq    : flush sequence number
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_complete_flush(cy_worker_thread_info_t* worker, uint32_t seq)
+{
+    // Work items and deferrable work are not on the event queue, so any that were pending
+    // when the flush was requested are run now
+    cy_worker_thread_run_items(worker, cy_worker_thread_take_items(worker));
+    cy_worker_thread_run_deferred(worker);
+
+    cy_worker_seq_advance(&worker->flushed, seq);
+    cy_worker_thread_release_waiters(worker);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_check_flush
+//
+/* Completes the flushes whose markers were displaced from the event queue by
+ * @ref CY_WORKER_THREAD_OVERFLOW_DROP_OLDEST. Such a marker was the oldest queued entry, so all
+ * work queued before it has been taken once the work the worker was running has returned.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void cy_worker_thread_check_flush(cy_worker_thread_info_t* worker)
+{
+    uint32_t seq = worker->flush_evicted;
+    if ((int32_t)(seq - worker->flushed) > 0)
+    {
+        cy_worker_thread_complete_flush(worker, seq);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run
+//
+/* Runs one piece of work and records its statistics.
+ * @param   worker        : pointer to @ref cy_worker_thread_info_t
+ * @param   dispatch_info : work to run
+ * @param   timed         : true if dispatch_info->time holds when the work was queued
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run(cy_worker_thread_info_t* worker,
+                                 const cy_worker_dispatch_info_t* dispatch_info, bool timed)
+{
+    // Wakeups are not work that a caller queued
+    if (dispatch_info->work_func == cy_worker_thread_wakeup)
+    {
+        return;
+    }
+    if (dispatch_info->work_func == cy_worker_thread_flush_marker)
+    {
+        cy_worker_thread_complete_flush(worker, (uint32_t)(uintptr_t)dispatch_info->arg);
+        return;
+    }
+
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    cy_worker_thread_stats_t* stats = &worker->stats;
+    cy_time_t                 start;
+    cy_rtos_time_get(&start);
+    if (timed)
+    {
+        (void)cy_rtos_atomic_add(
+            &stats->latency[cy_worker_stats_bucket(start - dispatch_info->time)], 1);
+    }
+
+    dispatch_info->work_func(dispatch_info->arg);
+
+    cy_time_t end;
+    cy_rtos_time_get(&end);
+    (void)cy_rtos_atomic_add(&stats->run_time[cy_worker_stats_bucket(end - start)], 1);
+    (void)cy_rtos_atomic_add(&stats->completed, 1);
+    #else
+    CY_UNUSED_PARAMETER(timed);
+    dispatch_info->work_func(dispatch_info->arg);
+    #endif // defined(CY_WORKER_THREAD_ENABLE_STATS)
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run_items
+//
+/* Runs work items taken with @ref cy_worker_thread_take_items. Each item stops being pending
+ * before its function is called so that the function can queue it again.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   items  : items to run
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run_items(cy_worker_thread_info_t* worker, cy_work_item_t* items)
+{
+    while (items != NULL)
+    {
+        cy_work_item_t*           next          = items->next;
+        cy_worker_dispatch_info_t dispatch_info = { .work_func = items->work_func,
+                                                    .arg       = items->arg };
+        items->pending = 0;
+        cy_worker_thread_run(worker, &dispatch_info, false);
+        items = next;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run_deferred
+//
+/* Runs all held deferrable work.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run_deferred(cy_worker_thread_info_t* worker)
+{
+    cy_worker_dispatch_info_t dispatch_info;
+    cy_time_t                 timeout_ms = CY_RTOS_NEVER_TIMEOUT;
+    while (cy_worker_thread_get_deferred(worker, &dispatch_info, &timeout_ms, true))
+    {
+        cy_worker_thread_run(worker, &dispatch_info, true);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run_entry
+//
+/* Runs work taken from a queue. Work queued with a payload is passed the copy of the payload
+ * held in the entry.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   entry  : work to run
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run_entry(cy_worker_thread_info_t* worker, cy_worker_entry_t* entry)
+{
+    if (entry->dispatch_info.arg == &cy_worker_payload_tag)
+    {
+        entry->dispatch_info.arg = entry->payload;
+    }
+    cy_worker_thread_run(worker, &entry->dispatch_info, true);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_batch
+//
+/* Takes the next work of a batch from lane 0 if it is already queued. Cancelled work is
+ * dropped.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   entry  : receives the work
+ * @return  true if work was taken
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_get_batch(cy_worker_thread_info_t* worker, cy_worker_entry_t* entry)
+{
+    while (cy_rtos_queue_get(&worker->event_queue, entry, 0) == CY_RSLT_SUCCESS)
+    {
+        if (!cy_worker_thread_skip(worker, 0, entry))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+static void cy_worker_thread_func(cy_thread_arg_t arg);
+static cy_rslt_t cy_worker_thread_enqueue_begin(cy_worker_thread_info_t* worker);
+static cy_rslt_t cy_worker_thread_enter(cy_worker_thread_info_t* worker);
+static inline void cy_worker_thread_enqueue_end(cy_worker_thread_info_t* worker);
+static void cy_worker_thread_wake(cy_worker_thread_info_t* worker);
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_grow
+//
+/* Starts one more thread of an elastic pool if the work just taken shows that work is backing
+ * up. Called by the pool threads, so threads are only ever created from thread context. Adding
+ * a thread holds off termination like an enqueue request does, so the thread is always known
+ * to a concurrent delete.
+ * @param   pool          : elastic pool
+ * @param   dispatch_info : work taken from the event queue
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_pool_grow(cy_worker_pool_t* pool,
+                                const cy_worker_dispatch_info_t* dispatch_info)
+{
+    const cy_worker_pool_params_t* params = &pool->params;
+    if ((pool->num_threads >= params->max_threads) || (dispatch_info->work_func == NULL) ||
+        (dispatch_info->work_func == cy_worker_thread_wakeup))
+    {
+        return;
+    }
+
+    size_t backlog = 0;
+    (void)cy_rtos_queue_count(&pool->worker.event_queue, &backlog);
+    uint32_t threshold = ((params->grow_backlog == 0) && (params->grow_latency_ms == 0))
+        ? 1
+        : params->grow_backlog;
+    bool grow = ((threshold != 0) && (backlog >= threshold));
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    cy_time_t now;
+    cy_rtos_time_get(&now);
+    grow = grow || ((params->grow_latency_ms != 0) &&
+                    ((cy_time_t)(now - dispatch_info->time) >= params->grow_latency_ms));
+    #endif
+
+    // Only one thread is added or joined at a time
+    if (!grow || !cy_rtos_atomic_cas(&pool->resizing, 0, 1))
+    {
+        return;
+    }
+    if (cy_worker_thread_enqueue_begin(&pool->worker) == CY_RSLT_SUCCESS)
+    {
+        // A retired slot keeps its stack slice until its thread has been joined
+        uint32_t slot  = params->max_threads;
+        uint32_t state = cyhal_system_critical_section_enter();
+        for (uint32_t i = 0; i < params->max_threads; i++)
+        {
+            if (((pool->live | pool->retired) & (1UL << i)) == 0)
+            {
+                slot        = i;
+                pool->live |= (1UL << i);
+                pool->num_threads++;
+                break;
+            }
+        }
+        cyhal_system_critical_section_exit(state);
+
+        if (slot != params->max_threads)
+        {
+            const cy_worker_thread_params_t* thread_params = &params->thread_params;
+            uint32_t stack_slice = thread_params->stack_size & ~CY_RTOS_ALIGNMENT_MASK;
+            cy_rslt_t result = cy_rtos_thread_create(&pool->threads[slot], cy_worker_thread_func,
+                                                     thread_params->name,
+                                                     (thread_params->stack != NULL)
+                                                     ? &thread_params->stack[slot * stack_slice]
+                                                     : NULL,
+                                                     thread_params->stack_size,
+                                                     thread_params->priority,
+                                                     (cy_thread_arg_t)&pool->worker);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                state = cyhal_system_critical_section_enter();
+                pool->live &= ~(1UL << slot);
+                pool->num_threads--;
+                cyhal_system_critical_section_exit(state);
+            }
+        }
+        cy_worker_thread_enqueue_end(&pool->worker);
+    }
+    pool->resizing = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_idle_timeout
+//
+/* Bounds the wait for work of an elastic pool thread by the idle timeout while the pool has
+ * more than its minimum number of threads.
+ * @param   pool       : elastic pool
+ * @param   timeout_ms : wait for work, shortened to the idle timeout if that is earlier
+ * @return  true if the wait is bounded by the idle timeout
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_pool_idle_timeout(const cy_worker_pool_t* pool, cy_time_t* timeout_ms)
+{
+    if ((pool->num_threads <= pool->params.num_threads) ||
+        (*timeout_ms < pool->params.idle_timeout_ms))
+    {
+        return false;
+    }
+    *timeout_ms = pool->params.idle_timeout_ms;
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_retire
+//
+/* Retires the calling thread of an elastic pool after it stayed idle for the idle timeout, as
+ * long as the pool keeps its minimum number of threads. The thread has to exit once this
+ * returns true; another pool thread is woken to join it. Nothing is retired once the pool is
+ * terminating, the thread then stays to consume its terminating event.
+ * @param   pool : elastic pool
+ * @return  true if the thread was retired
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_pool_retire(cy_worker_pool_t* pool)
+{
+    cy_thread_t self;
+    if ((cy_rtos_thread_get_handle(&self) != CY_RSLT_SUCCESS) ||
+        (cy_worker_thread_enqueue_begin(&pool->worker) != CY_RSLT_SUCCESS))
+    {
+        return false;
+    }
+
+    bool     retire = false;
+    uint32_t state  = cyhal_system_critical_section_enter();
+    for (uint32_t i = 0; (i < pool->params.max_threads) &&
+         (pool->num_threads > pool->params.num_threads); i++)
+    {
+        if (((pool->live & (1UL << i)) != 0) && (pool->threads[i] == self))
+        {
+            pool->live    &= ~(1UL << i);
+            pool->retired |= (1UL << i);
+            pool->num_threads--;
+            retire = true;
+            break;
+        }
+    }
+    cyhal_system_critical_section_exit(state);
+
+    if (retire)
+    {
+        cy_worker_thread_wake(&pool->worker);
+    }
+    cy_worker_thread_enqueue_end(&pool->worker);
+    return retire;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_reap
+//
+/* Joins the retired threads of an elastic pool, which releases their resources and makes their
+ * slots available again. Once the pool is terminating they are joined by the delete instead.
+ * @param   pool : elastic pool
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_pool_reap(cy_worker_pool_t* pool)
+{
+    if ((pool->retired == 0) || !cy_rtos_atomic_cas(&pool->resizing, 0, 1))
+    {
+        return;
+    }
+    if (cy_worker_thread_enqueue_begin(&pool->worker) == CY_RSLT_SUCCESS)
+    {
+        for (uint32_t i = 0; i < pool->params.max_threads; i++)
+        {
+            // A retired thread exits right away, so the join does not block for long
+            if (((pool->retired & (1UL << i)) != 0) &&
+                (cy_rtos_thread_join(&pool->threads[i]) == CY_RSLT_SUCCESS))
+            {
+                uint32_t state = cyhal_system_critical_section_enter();
+                pool->retired &= ~(1UL << i);
+                cyhal_system_critical_section_exit(state);
+            }
+        }
+        cy_worker_thread_enqueue_end(&pool->worker);
+    }
+    pool->resizing = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_func
+//
+/* Worker Thread to dispatch the events that added to the event queue.
+ * It will wait indefinitely for a item to be queued and will terminate
+ * when the NULL work function is queued by delete. It will process all
+ * events before the terminating event. Work on the higher priority lanes
+ * is always dispatched before work on the event queue (lane 0). Each time
+ * it wakes up, up to batch_size items that are already on the event queue
+ * are taken one at a time without blocking and dispatched back-to-back.
+ * While delayed or periodic work is pending, the wait for new work is
+ * bounded by the earliest expiry.
+ * Work with a deadline is dispatched earliest deadline first, after the
+ * higher lanes and expired delayed work but before lane 0. Deferrable work
+ * is held until the worker is awake for other work or its slack runs out.
+ * Intrusive work items are run as a group whenever any are pending. While
+ * the worker is paused it parks before taking the next piece of work.
+ * Threads of an elastic pool also grow, retire and join pool threads.
+ * @param   arg : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_func(cy_thread_arg_t arg)
+{
+    cy_worker_entry_t         queued;
+    cy_worker_entry_t         entry;
+    cy_worker_thread_info_t*  worker    = (cy_worker_thread_info_t*)arg;
+    cy_worker_pool_t*         pool      = (cy_worker_pool_t*)worker->pool;
+    bool                      terminate = false;
+    bool                      awake     = false;
+
+    while (!terminate)
+    {
+        cy_worker_thread_check_pause(worker);
+        cy_worker_thread_check_flush(worker);
+        if (pool != NULL)
+        {
+            cy_worker_pool_reap(pool);
+        }
+
+        cy_time_t timeout_ms;
+        if (cy_worker_thread_get_lane(worker, &entry) ||
+            cy_worker_thread_get_expired(worker, &entry.dispatch_info, &timeout_ms) ||
+            cy_worker_thread_get_periodic(worker, &entry.dispatch_info, &timeout_ms) ||
+            cy_worker_thread_get_deadline(worker, &entry.dispatch_info) ||
+            cy_worker_thread_get_deferred(worker, &entry.dispatch_info, &timeout_ms, awake))
+        {
+            cy_worker_thread_run_entry(worker, &entry);
+            awake = true;
+            continue;
+        }
+
+        cy_work_item_t* items = cy_worker_thread_take_items(worker);
+        if (items != NULL)
+        {
+            cy_worker_thread_run_items(worker, items);
+            awake = true;
+            continue;
+        }
+
+        // Only work that was queued, not a wakeup or a timeout, releases deferrable work
+        awake = false;
+        cy_worker_thread_retire_idle(worker);
+        bool idle = (pool != NULL) && cy_worker_pool_idle_timeout(pool, &timeout_ms);
+        if (cy_rtos_queue_get(&worker->event_queue, &queued, timeout_ms) != CY_RSLT_SUCCESS)
+        {
+            terminate = idle && cy_worker_pool_retire(pool);
+            continue;
+        }
+        if (cy_worker_thread_skip(worker, 0, &queued))
+        {
+            continue;
+        }
+        if (pool != NULL)
+        {
+            cy_worker_pool_grow(pool, &queued.dispatch_info);
+        }
+
+        // The rest of the batch is only taken while it is already queued, one entry at a time,
+        // so a single entry is kept on the stack whatever the batch size
+        uint32_t count = 0;
+        do
+        {
+            count++;
+            cy_worker_thread_check_pause(worker);
+            cy_worker_thread_check_flush(worker);
+
+            // Work queued on a higher lane or with a deadline while the batch runs still
+            // goes first
+            while (cy_worker_thread_get_lane(worker, &entry) ||
+                   cy_worker_thread_get_deadline(worker, &entry.dispatch_info))
+            {
+                cy_worker_thread_run_entry(worker, &entry);
+            }
+
+            if (queued.dispatch_info.work_func != NULL)
+            {
+                awake = awake || (queued.dispatch_info.work_func != cy_worker_thread_wakeup);
+                cy_worker_thread_run_entry(worker, &queued);
+            }
+            else
+            {
+                terminate = true;
+            }
+        } while (!terminate && (count < worker->batch_size) &&
+                 cy_worker_thread_get_batch(worker, &queued));
+
+        (void)cy_rtos_atomic_add(&worker->batch_count, 1);
+        (void)cy_rtos_atomic_add(&worker->batch_items, count);
+    }
+    // Items queued after the last check and held deferrable work still run, their owners
+    // expect them to
+    cy_worker_thread_run_items(worker, cy_worker_thread_take_items(worker));
+    cy_worker_thread_run_deferred(worker);
+    cy_rtos_thread_exit();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_storage_free
+//
+/* Releases the delayed, deadline and coalesced work storage of a worker. Storage provided by
+ * the caller is only forgotten.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_storage_free(cy_worker_thread_info_t* worker)
+{
+    if (!worker->static_mem)
+    {
+        free(worker->delayed);
+        free(worker->deadline);
+        free(worker->deferred);
+        free(worker->coalesce);
+    }
+    worker->delayed        = NULL;
+    worker->delayed_count  = 0;
+    worker->deadline       = NULL;
+    worker->deadline_count = 0;
+    worker->deferred       = NULL;
+    worker->deferred_count = 0;
+    worker->coalesce       = NULL;
+    worker->coalesce_size  = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_queues_deinit
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_queues_deinit(cy_worker_thread_info_t* worker)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    for (uint32_t lane = 1; (lane < worker->num_lanes) && (result == CY_RSLT_SUCCESS); lane++)
+    {
+        result = cy_rtos_queue_deinit(&worker->lane_queues[lane - 1]);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cy_rtos_queue_deinit(&worker->event_queue);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        cy_worker_thread_storage_free(worker);
+
+        // Periodic work that was still scheduled can be started again on another worker
+        while (worker->periodic != NULL)
+        {
+            worker->periodic->state = 0;
+            worker->periodic        = worker->periodic->next;
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_queue_init
+//
+/* Creates the queue of one lane, in the caller provided storage for statically created workers.
+ * @param   worker      : pointer to @ref cy_worker_thread_info_t
+ * @param   params      : requested parameters for the worker
+ * @param   lane        : lane the queue is for
+ * @param   num_entries : capacity of the queue
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_queue_init(cy_worker_thread_info_t* worker,
+                                             const cy_worker_thread_params_t* params,
+                                             uint32_t lane, size_t num_entries)
+{
+    cy_queue_t* queue = (lane == 0) ? &worker->event_queue : &worker->lane_queues[lane - 1];
+    if (worker->static_mem)
+    {
+        uint8_t* storage = (uint8_t*)params->queue_storage +
+                           (lane * CY_WORKER_THREAD_PAYLOAD_QUEUE_STORAGE_SIZE(
+                                num_entries, worker->payload_size));
+        return cy_rtos_queue_init_static(queue, num_entries,
+                                         CY_WORKER_THREAD_QUEUE_ENTRY_SIZE(worker->payload_size),
+                                         storage);
+    }
+    return cy_rtos_queue_init(queue, num_entries,
+                              CY_WORKER_THREAD_QUEUE_ENTRY_SIZE(worker->payload_size));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_queues_init
+//
+/* Applies the queueing parameters and creates the event queue, the queues for any
+ * additional priority lanes and the delayed, deadline and coalesced work storage. Nothing is
+ * allocated from the heap if params has a thread control block.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   params : requested parameters for the worker
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_queues_init(cy_worker_thread_info_t* worker,
+                                              const cy_worker_thread_params_t* params)
+{
+    size_t num_entries = (params->num_entries != 0)
+        ? params->num_entries
+        : CY_WORKER_DEFAULT_ENTRIES;
+    worker->num_lanes  = (params->num_lanes != 0) ? params->num_lanes : 1;
+    worker->batch_size = (params->batch_size != 0) ? params->batch_size : 1;
+    worker->overflow   = params->overflow;
+    worker->static_mem = (params->thread_cb != NULL);
+    // Payloads are copied in whole words
+    worker->payload_size = (params->payload_size + 3U) & ~3U;
+    if ((worker->num_lanes > CY_WORKER_THREAD_MAX_LANES) ||
+        (worker->batch_size > CY_WORKER_THREAD_MAX_BATCH) ||
+        (params->payload_size > CY_WORKER_THREAD_MAX_PAYLOAD))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if (worker->static_mem &&
+        ((params->stack == NULL) || (params->queue_storage == NULL) ||
+         ((params->num_delayed != 0) && (params->delayed_storage == NULL)) ||
+         ((params->num_deadline != 0) && (params->deadline_storage == NULL)) ||
+         ((params->num_deferred != 0) && (params->deferred_storage == NULL)) ||
+         ((params->num_coalesce != 0) && (params->coalesce_storage == NULL))))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    if (params->num_delayed != 0)
+    {
+        worker->delayed = worker->static_mem
+            ? params->delayed_storage
+            : malloc(params->num_delayed * sizeof(cy_worker_timed_info_t));
+        if (worker->delayed == NULL)
+        {
+            return CY_RTOS_NO_MEMORY;
+        }
+        worker->delayed_size = params->num_delayed;
+    }
+    if (params->num_deadline != 0)
+    {
+        worker->deadline = worker->static_mem
+            ? params->deadline_storage
+            : malloc(params->num_deadline * sizeof(cy_worker_timed_info_t));
+        if (worker->deadline == NULL)
+        {
+            cy_worker_thread_storage_free(worker);
+            return CY_RTOS_NO_MEMORY;
+        }
+        worker->deadline_size = params->num_deadline;
+    }
+    if (params->num_deferred != 0)
+    {
+        worker->deferred = worker->static_mem
+            ? params->deferred_storage
+            : malloc(params->num_deferred * sizeof(cy_worker_timed_info_t));
+        if (worker->deferred == NULL)
+        {
+            cy_worker_thread_storage_free(worker);
+            return CY_RTOS_NO_MEMORY;
+        }
+        worker->deferred_size = params->num_deferred;
+    }
+    if (params->num_coalesce != 0)
+    {
+        // Unused items are recognized by pending being 0
+        if (worker->static_mem)
+        {
+            worker->coalesce = params->coalesce_storage;
+            memset(worker->coalesce, 0, params->num_coalesce * sizeof(cy_work_item_t));
+        }
+        else
+        {
+            worker->coalesce =
+                (cy_work_item_t*)calloc(params->num_coalesce, sizeof(cy_work_item_t));
+        }
+        if (worker->coalesce == NULL)
+        {
+            cy_worker_thread_storage_free(worker);
+            return CY_RTOS_NO_MEMORY;
+        }
+        worker->coalesce_size = params->num_coalesce;
+    }
+
+    cy_rslt_t result = cy_worker_thread_queue_init(worker, params, 0, num_entries);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        cy_worker_thread_storage_free(worker);
+    }
+    for (uint32_t lane = 1; (lane < worker->num_lanes) && (result == CY_RSLT_SUCCESS); lane++)
+    {
+        result = cy_worker_thread_queue_init(worker, params, lane, num_entries);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            // Release the queues that were created
+            worker->num_lanes = lane;
+            cy_worker_thread_queues_deinit(worker);
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_deque_lock
+//
+/* Takes the lock of a deque. Interrupts are masked on this core while it is held, so an ISR
+ * queueing work cannot spin on a lock held by the code it interrupted; other cores spin for
+ * the few instructions it is held.
+ * @param   deque : deque to lock
+ * @return  the interrupt state to pass to @ref cy_worker_deque_unlock
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_worker_deque_lock(cy_worker_deque_t* deque)
+{
+    uint32_t state = cyhal_system_critical_section_enter();
+    while (!cy_rtos_atomic_cas(&deque->lock, 0, 1))
+    {
+    }
+    return state;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_deque_unlock
+//
+/* Releases the lock of a deque taken with @ref cy_worker_deque_lock.
+ * @param   deque : deque to unlock
+ * @param   state : interrupt state returned by @ref cy_worker_deque_lock
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_deque_unlock(cy_worker_deque_t* deque, uint32_t state)
+{
+    // The updates of the deque are visible before the lock is seen free
+    cy_rtos_memory_barrier();
+    deque->lock = 0;
+    cyhal_system_critical_section_exit(state);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_deque_push
+//
+/* Adds work to the tail of a deque.
+ * @param   deque         : deque to add the work to
+ * @param   dispatch_info : work to add
+ * @return  true if the work was added, false if the deque is full
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_deque_push(cy_worker_deque_t* deque,
+                                 const cy_worker_dispatch_info_t* dispatch_info)
+{
+    uint32_t state = cy_worker_deque_lock(deque);
+    bool     added = (deque->count != deque->size);
+    if (added)
+    {
+        cy_worker_dispatch_info_t* entries = (cy_worker_dispatch_info_t*)deque->entries;
+        entries[(deque->head + deque->count) % deque->size] = *dispatch_info;
+        deque->count++;
+    }
+    cy_worker_deque_unlock(deque, state);
+    return added;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_deque_pop
+//
+/* Removes work from a deque. The owning thread takes the oldest work from the head so that
+ * work queued to one thread still runs in order; thieves take the newest work from the tail.
+ * @param   deque         : deque to take the work from
+ * @param   steal         : true if the caller does not own the deque
+ * @param   dispatch_info : receives the work
+ * @return  true if work was taken, false if the deque is empty
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_deque_pop(cy_worker_deque_t* deque, bool steal,
+                                cy_worker_dispatch_info_t* dispatch_info)
+{
+    // Empty deques are skipped without taking their lock
+    if (deque->count == 0)
+    {
+        return false;
+    }
+
+    uint32_t state = cy_worker_deque_lock(deque);
+    bool     taken = (deque->count != 0);
+    if (taken)
+    {
+        cy_worker_dispatch_info_t* entries = (cy_worker_dispatch_info_t*)deque->entries;
+        deque->count--;
+        if (steal)
+        {
+            *dispatch_info = entries[(deque->head + deque->count) % deque->size];
+        }
+        else
+        {
+            *dispatch_info = entries[deque->head];
+            deque->head    = (deque->head + 1) % deque->size;
+        }
+    }
+    cy_worker_deque_unlock(deque, state);
+    return taken;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_find_work
+//
+/* Takes work from the deque of a pool thread, or steals it from the other deques.
+ * @param   pool          : pool the thread belongs to
+ * @param   index         : index of the thread's own deque
+ * @param   dispatch_info : receives the work
+ * @return  true if work was taken
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_pool_find_work(cy_worker_pool_t* pool, uint32_t index,
+                                     cy_worker_dispatch_info_t* dispatch_info)
+{
+    bool found = cy_worker_deque_pop(&pool->deques[index], false, dispatch_info);
+    for (uint32_t i = 1; (i < pool->num_threads) && !found; i++)
+    {
+        found = cy_worker_deque_pop(&pool->deques[(index + i) % pool->num_threads], true,
+                                    dispatch_info);
+    }
+    return found;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_stealing_func
+//
+/* Thread of a work-stealing pool. Runs work from its own deque first and steals from the other
+ * deques of the pool once its own deque is empty. It sleeps on its thread notification while
+ * there is no work anywhere in the pool, and exits once the pool refuses new work and all
+ * queued work has been run.
+ * @param   arg : pointer to the @ref cy_worker_deque_t owned by this thread
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_pool_stealing_func(cy_thread_arg_t arg)
+{
+    cy_worker_dispatch_info_t dispatch_info;
+    cy_worker_deque_t*        own   = (cy_worker_deque_t*)arg;
+    cy_worker_pool_t*         pool  = (cy_worker_pool_t*)own->pool;
+    uint32_t                  index = (uint32_t)(own - pool->deques);
+
+    while (1)
+    {
+        // Once no enqueue request is running any more, all work is on the deques
+        bool closed = (pool->worker.enqueue_count == CY_WORKER_THREAD_CLOSED);
+        bool found  = cy_worker_pool_find_work(pool, index, &dispatch_info);
+        if (!found && !closed)
+        {
+            // Producers check the flag after they push, so either the scan below sees their
+            // work or they see the flag and notify this thread
+            own->idle = 1;
+            cy_rtos_memory_barrier();
+            found = cy_worker_pool_find_work(pool, index, &dispatch_info);
+            if (found)
+            {
+                // A producer may have notified this thread as well, which only makes a later
+                // wait return early
+                own->idle = 0;
+            }
+        }
+
+        if (found)
+        {
+            dispatch_info.work_func(dispatch_info.arg);
+        }
+        else if (closed)
+        {
+            break;
+        }
+        else
+        {
+            cy_rtos_thread_wait_notification(CY_RTOS_NEVER_TIMEOUT);
+        }
+    }
+    cy_rtos_thread_exit();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_stealing_enqueue
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_pool_stealing_enqueue(cy_worker_pool_t* pool,
+                                                 cy_worker_thread_func_t* work_func, void* arg)
+{
+    cy_worker_dispatch_info_t dispatch_info = { .work_func = work_func, .arg = arg };
+    uint32_t                  target        = pool->num_threads;
+
+    // Work queued from a pool thread stays local to that thread
+    if (!is_in_isr())
+    {
+        cy_thread_t self;
+        if (cy_rtos_thread_get_handle(&self) == CY_RSLT_SUCCESS)
+        {
+            for (uint32_t i = 0; i < pool->num_threads; i++)
+            {
+                if (pool->threads[i] == self)
+                {
+                    target = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Keeps the pool threads from exiting before the work is on a deque
+    cy_rslt_t result = cy_worker_thread_enter(&pool->worker);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    if (target == pool->num_threads)
+    {
+        target = (cy_rtos_atomic_add(&pool->next_deque, 1) - 1U) % pool->num_threads;
+    }
+
+    // Fall back to the other deques if the preferred one is full
+    bool queued = false;
+    for (uint32_t i = 0; (i < pool->num_threads) && !queued; i++)
+    {
+        queued = cy_worker_deque_push(&pool->deques[(target + i) % pool->num_threads],
+                                      &dispatch_info);
+    }
+
+    // Wake the owner if it is idle, otherwise any idle thread so that it can steal the work.
+    // Clearing the flag claims the wakeup, so each idle thread is notified once.
+    cy_rtos_memory_barrier();
+    for (uint32_t i = 0; (i < pool->num_threads) && queued; i++)
+    {
+        uint32_t candidate = (target + i) % pool->num_threads;
+        if ((pool->deques[candidate].idle != 0) &&
+            cy_rtos_atomic_cas(&pool->deques[candidate].idle, 1, 0))
+        {
+            cy_rtos_thread_set_notification(&pool->threads[candidate]);
+            break;
+        }
+    }
+    cy_worker_thread_enqueue_end(&pool->worker);
+    return queued ? CY_RSLT_SUCCESS : CY_RTOS_QUEUE_FULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_stealing_stop
+//
+/* Terminates the threads of a work-stealing pool once all queued work has been run and
+ * releases the deque storage.
+ * @param   pool : pool to stop
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_pool_stealing_stop(cy_worker_pool_t* pool)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if (pool->worker.state == CY_WORKER_THREAD_VALID)
+    {
+        pool->worker.state = CY_WORKER_THREAD_TERMINATING;
+        cyhal_system_critical_section_exit(state);
+
+        // Refuse new work and let enqueue requests that are already running finish; the
+        // threads exit once they find the deques empty after that
+        (void)cy_rtos_thread_get_handle(&pool->worker.stopper);
+        (void)cy_rtos_atomic_add(&pool->worker.enqueue_count, CY_WORKER_THREAD_CLOSED);
+        while (pool->worker.enqueue_count != CY_WORKER_THREAD_CLOSED)
+        {
+            // Woken by the request that ends last
+            (void)cy_rtos_thread_wait_notification(CY_RTOS_NEVER_TIMEOUT);
+        }
+        pool->worker.stopper = NULL;
+        state = cyhal_system_critical_section_enter();
+    }
+    if (pool->worker.state == CY_WORKER_THREAD_TERMINATING)
+    {
+        cyhal_system_critical_section_exit(state);
+        for (uint32_t i = 0; i < pool->num_threads; i++)
+        {
+            cy_rtos_thread_set_notification(&pool->threads[i]);
+        }
+        for (uint32_t i = 0; i < pool->num_threads; i++)
+        {
+            result = cy_rtos_thread_join(&pool->threads[i]);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                return result;
+            }
+        }
+        state = cyhal_system_critical_section_enter();
+        pool->worker.state = CY_WORKER_THREAD_JOIN_COMPLETE;
+    }
+    if (pool->worker.state == CY_WORKER_THREAD_JOIN_COMPLETE)
+    {
+        // All deques share one allocation that is owned by the first deque
+        free(pool->deques[0].entries);
+        memset(pool->deques, 0, sizeof(pool->deques));
+        pool->worker.state = CY_WORKER_THREAD_INVALID;
+    }
+    cyhal_system_critical_section_exit(state);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_unpause
+//
+/* Resumes the threads of a paused worker.
+ * @param   worker  : pointer to @ref cy_worker_thread_info_t
+ * @param   threads : threads draining the event queue
+ * @param   live    : mask of the entries in threads that are taking work
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_unpause(cy_worker_thread_info_t* worker, cy_thread_t* threads,
+                                     const uint32_t* live)
+{
+    if (worker->paused != 0)
+    {
+        worker->paused = 0;
+        for (uint32_t i = 0; i < CY_WORKER_POOL_MAX_THREADS; i++)
+        {
+            if ((*live & (1UL << i)) != 0)
+            {
+                (void)cy_rtos_thread_set_notification(&threads[i]);
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_stop
+//
+/* Terminates all threads draining the worker's event queue and releases the queue. One
+ * terminating event is queued per thread; each thread exits after consuming one of them.
+ * The masks are read once no enqueue request is running, so an elastic pool cannot add or
+ * retire threads behind the snapshot.
+ * @param   worker  : pointer to @ref cy_worker_thread_info_t owning the event queue
+ * @param   threads : threads draining the event queue
+ * @param   live    : mask of the entries in threads that are taking work
+ * @param   retired : mask of the entries in threads that exited but were not joined yet
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_stop(cy_worker_thread_info_t* worker, cy_thread_t* threads,
+                                       const uint32_t* live, const uint32_t* retired)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if (worker->state != CY_WORKER_THREAD_INVALID)
+    {
+        // Don't allow terminating while cy_rtos_put_queue is running
+        if (worker->state == CY_WORKER_THREAD_VALID)
+        {
+            // A terminating event is queued that will break the while loop
+            // Note that this is ok because thread enqueue function will not
+            // allow NULL as a valid value for the work function.
+            worker->state = CY_WORKER_THREAD_TERMINATING;
+            cyhal_system_critical_section_exit(state);
+
+            // Refuse new work, then let enqueue requests that are already running finish so
+            // that their work cannot end up behind the terminating events. A paused worker is
+            // resumed first, a request may be blocked on its full queue.
+            (void)cy_rtos_thread_get_handle(&worker->stopper);
+            (void)cy_rtos_atomic_add(&worker->enqueue_count, CY_WORKER_THREAD_CLOSED);
+            cy_worker_thread_unpause(worker, threads, live);
+            while (worker->enqueue_count != CY_WORKER_THREAD_CLOSED)
+            {
+                // Woken by the request that ends last
+                (void)cy_rtos_thread_wait_notification(CY_RTOS_NEVER_TIMEOUT);
+            }
+            worker->stopper = NULL;
+
+            // A pause that was still in progress may have paused the worker again. Paused
+            // threads must run to consume their terminating events.
+            cy_worker_thread_unpause(worker, threads, live);
+
+            // The first event is not allowed to block so that a full queue is reported without
+            // side effects. No other work can be queued once terminating, so the threads are
+            // guaranteed to drain the queue and make room for the remaining terminating events.
+            cy_worker_entry_t terminate = { .dispatch_info = { .work_func = NULL, .arg = NULL } };
+            bool              first     = true;
+            cy_worker_entry_set_epoch(worker, &terminate);
+            for (uint32_t i = 0; (i < CY_WORKER_POOL_MAX_THREADS) && (result == CY_RSLT_SUCCESS);
+                 i++)
+            {
+                if ((*live & (1UL << i)) != 0)
+                {
+                    result = cy_rtos_queue_put(&worker->event_queue, &terminate,
+                                               first ? 0 : CY_RTOS_NEVER_TIMEOUT);
+                    first  = false;
+                }
+            }
+            if (result != CY_RSLT_SUCCESS)
+            {
+                // Could not enqueue termination task, return to valid state
+                state = cyhal_system_critical_section_enter();
+                worker->state = CY_WORKER_THREAD_VALID;
+                cyhal_system_critical_section_exit(state);
+                (void)cy_rtos_atomic_add(&worker->enqueue_count, 0U - CY_WORKER_THREAD_CLOSED);
+
+                return result;
+            }
+            state = cyhal_system_critical_section_enter();
+        }
+
+        if (worker->state != CY_WORKER_THREAD_JOIN_COMPLETE)
+        {
+            cyhal_system_critical_section_exit(state);
+            for (uint32_t i = 0; i < CY_WORKER_POOL_MAX_THREADS; i++)
+            {
+                if (((*live | *retired) & (1UL << i)) != 0)
+                {
+                    result = cy_rtos_thread_join(&threads[i]);
+                    if (result != CY_RSLT_SUCCESS)
+                    {
+                        return result;
+                    }
+                }
+            }
+            state = cyhal_system_critical_section_enter();
+            worker->state = CY_WORKER_THREAD_JOIN_COMPLETE;
+        }
+
+        if (worker->state != CY_WORKER_THREAD_INVALID)
+        {
+            cyhal_system_critical_section_exit(state);
+            result = cy_worker_thread_queues_deinit(worker);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                return result;
+            }
+            state = cyhal_system_critical_section_enter();
+            worker->state = CY_WORKER_THREAD_INVALID;
+        }
+    }
+
+    cyhal_system_critical_section_exit(state);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_create
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
+                                  const cy_worker_thread_params_t* params)
+{
+    // Param check
+    CY_ASSERT((params != NULL) && (new_worker != NULL));
+    CY_ASSERT((params->stack == NULL) || ((params->stack != NULL) && (params->stack_size != 0)));
+
+    // Start with a clean structure
+    memset(new_worker, 0, sizeof(cy_worker_thread_info_t));
+    new_worker->enqueue_count = CY_WORKER_THREAD_CLOSED;
+
+    cy_rslt_t result = cy_worker_thread_queues_init(new_worker, params);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        const char* name = (params->name != NULL)
+            ? params->name
+            : CY_WORKER_THREAD_DEFAULT_NAME;
+        new_worker->state         = CY_WORKER_THREAD_VALID;
+        new_worker->enqueue_count = 0;
+        result = (params->thread_cb != NULL)
+            ? cy_rtos_thread_create_static(&new_worker->thread, cy_worker_thread_func, name,
+                                           params->stack, params->stack_size, params->priority,
+                                           (cy_thread_arg_t)new_worker, params->thread_cb)
+            : cy_rtos_thread_create(&new_worker->thread, cy_worker_thread_func, name,
+                                    params->stack, params->stack_size, params->priority,
+                                    (cy_thread_arg_t)new_worker);
+
+        if (result != CY_RSLT_SUCCESS)
+        {
+            new_worker->state = CY_WORKER_THREAD_INVALID;
+            new_worker->enqueue_count = CY_WORKER_THREAD_CLOSED;
+            cy_worker_thread_queues_deinit(new_worker);
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_delete
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker)
+{
+    const uint32_t live    = 1;
+    const uint32_t retired = 0;
+    return cy_worker_thread_stop(old_worker, &old_worker->thread, &live, &retired);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
+                                   cy_worker_thread_func_t* work_func, void* arg)
+{
+    return cy_worker_thread_enqueue_prio(worker_info, work_func, arg, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_begin
+//
+/* Marks an enqueue request as in progress so the worker cannot start terminating until the
+ * matching call to @ref cy_worker_thread_enqueue_end. The worker of a work-stealing pool has
+ * no event queue and is refused.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_enqueue_begin(cy_worker_thread_info_t* worker)
+{
+    if (worker->stealing)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    return cy_worker_thread_enter(worker);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enter
+//
+/* Counts a request in enqueue_count unless the worker refuses new work. This only takes an
+ * atomic update, so interrupts are never masked on the enqueue path. End the request with
+ * @ref cy_worker_thread_enqueue_end.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_enter(cy_worker_thread_info_t* worker)
+{
+    uint32_t count;
+    do
+    {
+        count = worker->enqueue_count;
+        if ((count & CY_WORKER_THREAD_CLOSED) != 0)
+        {
+            return CY_WORKER_THREAD_ERR_THREAD_INVALID;
+        }
+    } while (!cy_rtos_atomic_cas(&worker->enqueue_count, count, count + 1));
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_end
+//
+/* Ends an enqueue request started with @ref cy_worker_thread_enqueue_begin. The last request to
+ * end once the worker refuses new work wakes the thread that is stopping the worker.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void cy_worker_thread_enqueue_end(cy_worker_thread_info_t* worker)
+{
+    if (cy_rtos_atomic_add(&worker->enqueue_count, (uint32_t)-1) == CY_WORKER_THREAD_CLOSED)
+    {
+        cy_thread_t stopper = worker->stopper;
+        if (stopper != NULL)
+        {
+            (void)cy_rtos_thread_set_notification(&stopper);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_wake
+//
+/* Wakes a worker that may be blocked on the event queue so that it re-evaluates the higher
+ * lanes and the delayed work. Must be called between @ref cy_worker_thread_enqueue_begin and
+ * @ref cy_worker_thread_enqueue_end so that the wakeup cannot end up behind a terminating
+ * event. If the event queue is full the worker is not blocked, so a failure is harmless.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_wake(cy_worker_thread_info_t* worker)
+{
+    cy_worker_entry_t wakeup_entry = { .dispatch_info.work_func = cy_worker_thread_wakeup };
+    cy_worker_entry_set_epoch(worker, &wakeup_entry);
+    (void)cy_rtos_queue_put(&worker->event_queue, &wakeup_entry, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_push_item
+//
+/* Links a work item that was just marked pending into the worker's pending list. Must be
+ * called between @ref cy_worker_thread_enqueue_begin and @ref cy_worker_thread_enqueue_end.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @param   item   : item to link
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_push_item(cy_worker_thread_info_t* worker, cy_work_item_t* item)
+{
+    CY_WORKER_STATS_ADD(worker, enqueued, 1);
+    cy_work_item_t* head;
+    do
+    {
+        head       = worker->items;
+        item->next = head;
+    } while (!cy_rtos_atomic_cas_ptr((void* volatile*)&worker->items, head, item));
+
+    if (head == NULL)
+    {
+        cy_worker_thread_wake(worker);
+    }
+}
+
+
+#if defined(CY_WORKER_THREAD_ENABLE_STATS)
+//--------------------------------------------------------------------------------------------------
+// cy_worker_stats_record_depth
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_stats_record_depth(cy_worker_thread_info_t* worker, cy_queue_t* queue)
+{
+    size_t depth;
+    if (cy_rtos_queue_count(queue, &depth) == CY_RSLT_SUCCESS)
+    {
+        uint32_t max_depth;
+        do
+        {
+            max_depth = worker->stats.max_depth;
+        } while (((uint32_t)depth > max_depth) &&
+                 !cy_rtos_atomic_cas(&worker->stats.max_depth, max_depth, (uint32_t)depth));
+    }
+}
+
+
+#endif // defined(CY_WORKER_THREAD_ENABLE_STATS)
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_default_timeout
+//
+/* Returns how long an enqueue request that has no timeout of its own waits for room in a full
+ * queue: without limit under @ref CY_WORKER_THREAD_OVERFLOW_BLOCK, otherwise not at all.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static inline cy_time_t cy_worker_thread_default_timeout(const cy_worker_thread_info_t* worker)
+{
+    return (worker->overflow == CY_WORKER_THREAD_OVERFLOW_BLOCK) ? CY_RTOS_NEVER_TIMEOUT : 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_put
+//
+/* Puts work on the queue of a lane, applying the overflow policy if the queue is still full
+ * after timeout_ms, and wakes the worker if needed. Must be called between
+ * @ref cy_worker_thread_enqueue_begin and @ref cy_worker_thread_enqueue_end.
+ * @param   worker     : pointer to @ref cy_worker_thread_info_t
+ * @param   lane       : lane to queue the work on
+ * @param   entry      : work to queue
+ * @param   timeout_ms : maximum time to wait for room before applying the policy
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_put(cy_worker_thread_info_t* worker, uint32_t lane,
+                                      cy_worker_entry_t* entry, cy_time_t timeout_ms)
+{
+    cy_queue_t* queue  = (lane == 0) ? &worker->event_queue : &worker->lane_queues[lane - 1];
+    bool        in_isr = is_in_isr();
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    cy_rtos_time_get(&entry->dispatch_info.time);
+    #endif
+    cy_worker_entry_set_epoch(worker, entry);
+
+    cy_rslt_t result = cy_rtos_queue_put(queue, entry, in_isr ? 0 : timeout_ms);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        switch (worker->overflow)
+        {
+            case CY_WORKER_THREAD_OVERFLOW_BLOCK:
+                // The put above already waited for room, an ISR fails like under FAIL
+                if (!in_isr)
+                {
+                    result = CY_RTOS_TIMEOUT;
+                }
+                break;
+
+            case CY_WORKER_THREAD_OVERFLOW_DROP_OLDEST:
+                while (result != CY_RSLT_SUCCESS)
+                {
+                    cy_worker_entry_t oldest;
+                    if (cy_rtos_queue_get(queue, &oldest, 0) == CY_RSLT_SUCCESS)
+                    {
+                        if (lane != 0)
+                        {
+                            (void)cy_rtos_atomic_add(&worker->lane_pending, (uint32_t)-1);
+                        }
+                        // A flush marker is not work, its flush completes as soon as the
+                        // worker is done with what it is running
+                        if (oldest.dispatch_info.work_func == cy_worker_thread_flush_marker)
+                        {
+                            cy_worker_seq_advance(&worker->flush_evicted,
+                                                  (uint32_t)(uintptr_t)oldest.dispatch_info.arg);
+                        }
+                        // A wakeup only matters while the worker is blocked on an empty queue
+                        else if (oldest.dispatch_info.work_func != cy_worker_thread_wakeup)
+                        {
+                            CY_WORKER_STATS_ADD(worker, dropped, 1);
+                        }
+                    }
+                    result = cy_rtos_queue_put(queue, entry, 0);
+                }
+                break;
+
+            case CY_WORKER_THREAD_OVERFLOW_DROP_NEWEST:
+                CY_WORKER_STATS_ADD(worker, dropped, 1);
+                return CY_RSLT_SUCCESS;
+
+            case CY_WORKER_THREAD_OVERFLOW_FAIL:
+            default:
+                break;
+        }
+    }
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+        cy_worker_stats_record_depth(worker, queue);
+        #endif
+        CY_WORKER_STATS_ADD(worker, enqueued, 1);
+
+        // A worker only blocks on the event queue after finding the higher lanes empty, so it
+        // needs a wakeup when they become non-empty.
+        if ((lane != 0) && (cy_rtos_atomic_add(&worker->lane_pending, 1) == 1))
+        {
+            cy_worker_thread_wake(worker);
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_lane
+//
+/* Queues work on a lane of a worker.
+ * @param   worker_info : pointer to @ref cy_worker_thread_info_t
+ * @param   work_func   : function to run
+ * @param   arg         : opaque arg to be used in function call
+ * @param   priority    : lane to queue the work on
+ * @param   timeout_ms  : maximum time to wait for room before applying the overflow policy
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_enqueue_lane(cy_worker_thread_info_t* worker_info,
+                                               cy_worker_thread_func_t* work_func, void* arg,
+                                               uint32_t priority, cy_time_t timeout_ms)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    if (priority >= worker_info->num_lanes)
+    {
+        cy_worker_thread_enqueue_end(worker_info);
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    cy_worker_entry_t entry = { .dispatch_info = { .work_func = work_func, .arg = arg } };
+    // Queue an event to be run by the worker thread
+    result = cy_worker_thread_put(worker_info, priority, &entry, timeout_ms);
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_timeout
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_timeout(cy_worker_thread_info_t* worker_info,
+                                           cy_worker_thread_func_t* work_func, void* arg,
+                                           cy_time_t timeout_ms)
+{
+    return cy_worker_thread_enqueue_lane(worker_info, work_func, arg, 0, timeout_ms);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_prio
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_prio(cy_worker_thread_info_t* worker_info,
+                                        cy_worker_thread_func_t* work_func, void* arg,
+                                        uint32_t priority)
+{
+    CY_ASSERT(worker_info != NULL);
+    return cy_worker_thread_enqueue_lane(worker_info, work_func, arg, priority,
+                                         cy_worker_thread_default_timeout(worker_info));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_delayed
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_delayed(cy_worker_thread_info_t* worker_info,
+                                           cy_worker_thread_func_t* work_func, void* arg,
+                                           cy_time_t delay_ms)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    if (delay_ms == 0)
+    {
+        return cy_worker_thread_enqueue_prio(worker_info, work_func, arg, 0);
+    }
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    cy_worker_timed_info_t entry = { .dispatch_info = { .work_func = work_func, .arg = arg } };
+    cy_rtos_time_get(&entry.time);
+    entry.time += delay_ms;
+
+    cy_worker_timed_info_t* heap  = (cy_worker_timed_info_t*)worker_info->delayed;
+    uint32_t                state = cyhal_system_critical_section_enter();
+    // The worker only needs to re-evaluate its wait if the new work expires first
+    bool wakeup = (worker_info->delayed_count == 0) ||
+                  cy_worker_time_before(entry.time, heap[0].time);
+    bool queued = cy_worker_heap_push(heap, &worker_info->delayed_count,
+                                      worker_info->delayed_size, &entry);
+    cyhal_system_critical_section_exit(state);
+
+    if (queued)
+    {
+        CY_WORKER_STATS_ADD(worker_info, enqueued, 1);
+    }
+    if (queued && wakeup)
+    {
+        cy_worker_thread_wake(worker_info);
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return queued ? CY_RSLT_SUCCESS : CY_RTOS_QUEUE_FULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_deferred
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_deferred(cy_worker_thread_info_t* worker_info,
+                                            cy_worker_thread_func_t* work_func, void* arg,
+                                            cy_time_t slack_ms)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    if (slack_ms == 0)
+    {
+        return cy_worker_thread_enqueue_prio(worker_info, work_func, arg, 0);
+    }
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    cy_time_t now;
+    cy_rtos_time_get(&now);
+    cy_worker_timed_info_t entry = { .dispatch_info = { .work_func = work_func, .arg = arg },
+                                     .time          = now + slack_ms };
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    entry.dispatch_info.time = now;
+    #endif
+
+    cy_worker_timed_info_t* heap  = (cy_worker_timed_info_t*)worker_info->deferred;
+    uint32_t                state = cyhal_system_critical_section_enter();
+    // The worker is only woken to shorten its wait, never to run the work right away
+    bool wakeup = (worker_info->deferred_count == 0) ||
+                  cy_worker_time_before(entry.time, heap[0].time);
+    bool queued = cy_worker_heap_push(heap, &worker_info->deferred_count,
+                                      worker_info->deferred_size, &entry);
+    cyhal_system_critical_section_exit(state);
+
+    if (queued)
+    {
+        CY_WORKER_STATS_ADD(worker_info, enqueued, 1);
+    }
+    if (queued && wakeup)
+    {
+        cy_worker_thread_wake(worker_info);
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return queued ? CY_RSLT_SUCCESS : CY_RTOS_QUEUE_FULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_deadline
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_deadline(cy_worker_thread_info_t* worker_info,
+                                            cy_worker_thread_func_t* work_func, void* arg,
+                                            cy_time_t deadline)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    cy_worker_timed_info_t entry = { .dispatch_info = { .work_func = work_func, .arg = arg },
+                                     .time          = deadline };
+    #if defined(CY_WORKER_THREAD_ENABLE_STATS)
+    cy_rtos_time_get(&entry.dispatch_info.time);
+    #endif
+
+    cy_worker_timed_info_t* heap  = (cy_worker_timed_info_t*)worker_info->deadline;
+    uint32_t                state = cyhal_system_critical_section_enter();
+    // A worker only blocks for new work once it has taken all work with a deadline
+    bool wakeup = (worker_info->deadline_count == 0);
+    bool queued = cy_worker_heap_push(heap, &worker_info->deadline_count,
+                                      worker_info->deadline_size, &entry);
+    cyhal_system_critical_section_exit(state);
+
+    if (queued)
+    {
+        CY_WORKER_STATS_ADD(worker_info, enqueued, 1);
+    }
+    if (queued && wakeup)
+    {
+        cy_worker_thread_wake(worker_info);
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return queued ? CY_RSLT_SUCCESS : CY_RTOS_QUEUE_FULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_periodic
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_periodic(cy_worker_thread_info_t* worker_info,
+                                            cy_worker_periodic_t* periodic,
+                                            cy_worker_thread_func_t* work_func, void* arg,
+                                            cy_time_t period_ms)
+{
+    CY_ASSERT((worker_info != NULL) && (periodic != NULL));
+    CY_ASSERT(work_func != NULL);
+    CY_ASSERT(period_ms != 0);
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    cy_time_t now;
+    cy_rtos_time_get(&now);
+    bool     wakeup = false;
+    uint32_t state  = cyhal_system_critical_section_enter();
+    if ((periodic->state & CY_WORKER_PERIODIC_SCHEDULED) != 0)
+    {
+        result = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        periodic->work_func = work_func;
+        periodic->arg       = arg;
+        periodic->worker    = worker_info;
+        periodic->period_ms = period_ms;
+        periodic->due       = now + period_ms;
+        periodic->overruns  = 0;
+        periodic->state     = CY_WORKER_PERIODIC_SCHEDULED;
+        // The worker only needs to re-evaluate its wait if the new work is due first
+        wakeup = cy_worker_periodic_link(worker_info, periodic);
+    }
+    cyhal_system_critical_section_exit(state);
+
+    if (wakeup)
+    {
+        cy_worker_thread_wake(worker_info);
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_stop_periodic
+//--------------------------------------------------------------------------------------------------
+void cy_worker_thread_stop_periodic(cy_worker_thread_info_t* worker_info,
+                                    cy_worker_periodic_t* periodic)
+{
+    CY_ASSERT((worker_info != NULL) && (periodic != NULL));
+    CY_UNUSED_PARAMETER(worker_info);
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if ((periodic->state & CY_WORKER_PERIODIC_LINKED) != 0)
+    {
+        // The list of the worker the work was scheduled on is walked, not the caller's
+        cy_worker_thread_info_t* owner = (cy_worker_thread_info_t*)periodic->worker;
+        CY_ASSERT(owner == worker_info);
+        cy_worker_periodic_t** link = &owner->periodic;
+        while ((*link != NULL) && (*link != periodic))
+        {
+            link = &(*link)->next;
+        }
+        if (*link != NULL)
+        {
+            *link = periodic->next;
+        }
+        periodic->state = 0;
+    }
+    else if ((periodic->state & CY_WORKER_PERIODIC_SCHEDULED) != 0)
+    {
+        // It is running, the run does not schedule it again
+        periodic->state |= CY_WORKER_PERIODIC_STOPPED;
+    }
+    cyhal_system_critical_section_exit(state);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_payload
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_payload(cy_worker_thread_info_t* worker_info,
+                                           cy_worker_thread_func_t* work_func,
+                                           const void* payload, size_t size)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+    CY_ASSERT((payload != NULL) || (size == 0));
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    if (size > worker_info->payload_size)
+    {
+        cy_worker_thread_enqueue_end(worker_info);
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    cy_worker_entry_t entry;
+    entry.dispatch_info.work_func = work_func;
+    entry.dispatch_info.arg       = &cy_worker_payload_tag;
+    memcpy(entry.payload, payload, size);
+    result = cy_worker_thread_put(worker_info, 0, &entry,
+                                      cy_worker_thread_default_timeout(worker_info));
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_work_item_init
+//--------------------------------------------------------------------------------------------------
+void cy_work_item_init(cy_work_item_t* item, cy_worker_thread_func_t* work_func, void* arg)
+{
+    CY_ASSERT(item != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    item->next      = NULL;
+    item->work_func = work_func;
+    item->arg       = arg;
+    item->pending   = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_item
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_item(cy_worker_thread_info_t* worker_info,
+                                        cy_work_item_t* item)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT((item != NULL) && (item->work_func != NULL));
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    // Only the request that marks the item pending links it, all others are merged into it
+    if (cy_rtos_atomic_cas(&item->pending, 0, 1))
+    {
+        cy_worker_thread_push_item(worker_info, item);
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_coalesced
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_coalesced(cy_worker_thread_info_t* worker_info,
+                                             cy_worker_thread_func_t* work_func, void* arg)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    // Look for a pending identical request, remembering a free item in case there is none
+    cy_work_item_t* item   = NULL;
+    bool            merged = false;
+    uint32_t        state  = cyhal_system_critical_section_enter();
+    for (uint32_t i = 0; (i < worker_info->coalesce_size) && !merged; i++)
+    {
+        cy_work_item_t* slot = &worker_info->coalesce[i];
+        if (slot->pending == 0)
+        {
+            item = (item == NULL) ? slot : item;
+        }
+        else if ((slot->work_func == work_func) && (slot->arg == arg))
+        {
+            merged = true;
+        }
+    }
+    if (merged)
+    {
+        CY_WORKER_STATS_ADD(worker_info, coalesced, 1);
+    }
+    else if (item != NULL)
+    {
+        item->work_func = work_func;
+        item->arg       = arg;
+        item->pending   = 1;
+    }
+    cyhal_system_critical_section_exit(state);
+
+    if (!merged)
+    {
+        if (item != NULL)
+        {
+            cy_worker_thread_push_item(worker_info, item);
+        }
+        else
+        {
+            cy_worker_entry_t entry = { .dispatch_info = { .work_func = work_func, .arg = arg } };
+            result = cy_worker_thread_put(worker_info, 0, &entry,
+                                          cy_worker_thread_default_timeout(worker_info));
+        }
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_completion_signal
+//
+/* Marks a completion handle done, notifying the waiting thread if there is one.
+ * @param   completion : pointer to @ref cy_worker_completion_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_completion_signal(cy_worker_completion_t* completion)
+{
+    // The waiter may release the handle as soon as it sees the done flag, so the waiter is
+    // read before the flag is set and the handle is not touched afterwards.
+    uint32_t    state;
+    cy_thread_t waiter;
+    do
+    {
+        state  = completion->state;
+        waiter = completion->waiter;
+    } while (!cy_rtos_atomic_cas(&completion->state, state, state | CY_WORKER_COMPLETION_DONE));
+
+    if ((state & CY_WORKER_COMPLETION_WAITING) != 0)
+    {
+        (void)cy_rtos_thread_set_notification(&waiter);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_complete
+//
+/* Runs work queued with @ref cy_worker_thread_enqueue_completion and then marks it done.
+ * @param   arg : pointer to @ref cy_worker_completion_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_complete(void* arg)
+{
+    cy_worker_completion_t* completion = (cy_worker_completion_t*)arg;
+    completion->work_func(completion->arg);
+    cy_worker_completion_signal(completion);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue_completion
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue_completion(cy_worker_thread_info_t* worker_info,
+                                              cy_worker_thread_func_t* work_func, void* arg,
+                                              cy_worker_completion_t* completion)
+{
+    CY_ASSERT(completion != NULL);
+    CY_ASSERT(work_func != NULL);
+
+    completion->work_func = work_func;
+    completion->arg       = arg;
+    completion->waiter    = NULL;
+    completion->state     = 0;
+    return cy_worker_thread_enqueue(worker_info, cy_worker_thread_complete, completion);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_completion_wait
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_completion_wait(cy_worker_completion_t* completion, cy_time_t timeout_ms)
+{
+    CY_ASSERT(completion != NULL);
+    CY_ASSERT(!is_in_isr());
+
+    cy_rslt_t result = cy_rtos_thread_get_handle(&completion->waiter);
+    if ((result != CY_RSLT_SUCCESS) ||
+        !cy_rtos_atomic_cas(&completion->state, 0, CY_WORKER_COMPLETION_WAITING))
+    {
+        // Already done
+        return result;
+    }
+
+    cy_time_t start;
+    cy_rtos_time_get(&start);
+    cy_time_t remaining = timeout_ms;
+    while ((completion->state & CY_WORKER_COMPLETION_DONE) == 0)
+    {
+        // Notifications meant for other purposes can wake the thread early, so the flag
+        // decides when the wait is over.
+        (void)cy_rtos_thread_wait_notification(remaining);
+        if (timeout_ms != CY_RTOS_NEVER_TIMEOUT)
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            cy_time_t elapsed = now - start;
+            if (elapsed >= timeout_ms)
+            {
+                // Withdraw the waiter unless the work completed in the meantime
+                return cy_rtos_atomic_cas(&completion->state, CY_WORKER_COMPLETION_WAITING, 0)
+                    ? CY_RTOS_TIMEOUT
+                    : CY_RSLT_SUCCESS;
+            }
+            remaining = timeout_ms - elapsed;
+        }
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_completion_is_done
+//--------------------------------------------------------------------------------------------------
+bool cy_worker_completion_is_done(const cy_worker_completion_t* completion)
+{
+    CY_ASSERT(completion != NULL);
+    return ((completion->state & CY_WORKER_COMPLETION_DONE) != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_cancel_items
+//
+/* Unlinks the pending work items for a function and argument pair. The list is detached with
+ * the same atomic update the worker uses to take it, so the items are filtered while no other
+ * core can reach them. The remaining items are then put back in front of any item queued
+ * meanwhile. Items the worker has already taken are not on the list any more and are left
+ * alone. Must be called between @ref cy_worker_thread_enqueue_begin and
+ * @ref cy_worker_thread_enqueue_end.
+ * @param   worker    : pointer to @ref cy_worker_thread_info_t
+ * @param   work_func : function of the work to remove
+ * @param   arg       : argument of the work to remove
+ * @return  the number of items removed
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_worker_thread_cancel_items(cy_worker_thread_info_t* worker,
+                                              cy_worker_thread_func_t* work_func, void* arg)
+{
+    cy_work_item_t* items;
+    do
+    {
+        items = worker->items;
+    } while ((items != NULL) &&
+             !cy_rtos_atomic_cas_ptr((void* volatile*)&worker->items, items, NULL));
+
+    uint32_t         removed = 0;
+    cy_work_item_t*  kept    = NULL;
+    cy_work_item_t** link    = &kept;
+    while (items != NULL)
+    {
+        cy_work_item_t* item = items;
+        items      = item->next;
+        item->next = NULL;
+        if ((item->work_func == work_func) && (item->arg == arg))
+        {
+            item->pending = 0;
+            removed++;
+        }
+        else
+        {
+            *link = item;
+            link  = &item->next;
+        }
+    }
+
+    if (kept != NULL)
+    {
+        cy_work_item_t* head;
+        do
+        {
+            head  = worker->items;
+            *link = head;
+        } while (!cy_rtos_atomic_cas_ptr((void* volatile*)&worker->items, head, kept));
+
+        // The worker may have found the list empty and blocked while it was detached
+        if (head == NULL)
+        {
+            cy_worker_thread_wake(worker);
+        }
+    }
+    return removed;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_cancel_timed
+//
+/* Removes the work for a function and argument pair from the delayed or deadline work. The
+ * remaining entries are pushed back in place, which moves nothing if none were removed.
+ * @param   heap       : delayed or deadline work storage
+ * @param   heap_count : number of entries in heap, updated on return
+ * @param   size       : capacity of heap
+ * @param   work_func  : function of the work to remove
+ * @param   arg        : argument of the work to remove
+ * @return  the number of entries removed
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_worker_thread_cancel_timed(cy_worker_timed_info_t* heap, uint32_t* heap_count,
+                                              uint32_t size, cy_worker_thread_func_t* work_func,
+                                              void* arg)
+{
+    uint32_t removed = 0;
+    uint32_t state   = cyhal_system_critical_section_enter();
+    uint32_t count   = *heap_count;
+    *heap_count = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // Pushing never writes beyond index i, so the entries still to be read are intact
+        cy_worker_timed_info_t entry = heap[i];
+        if ((entry.dispatch_info.work_func == work_func) && (entry.dispatch_info.arg == arg))
+        {
+            removed++;
+        }
+        else
+        {
+            (void)cy_worker_heap_push(heap, heap_count, size, &entry);
+        }
+    }
+    cyhal_system_critical_section_exit(state);
+    return removed;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_busy_lanes
+//
+/* Finds the lanes of a worker that have work queued.
+ * @param   worker : pointer to @ref cy_worker_thread_info_t
+ * @return  a mask with bit n set if lane n is not empty
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_worker_thread_busy_lanes(cy_worker_thread_info_t* worker)
+{
+    uint32_t lanes = 0;
+    for (uint32_t lane = 0; lane < worker->num_lanes; lane++)
+    {
+        cy_queue_t* queue = (lane == 0) ? &worker->event_queue : &worker->lane_queues[lane - 1];
+        size_t      count = 0;
+        if ((cy_rtos_queue_count(queue, &count) == CY_RSLT_SUCCESS) && (count != 0))
+        {
+            lanes |= 1U << lane;
+        }
+    }
+    return lanes;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_cancel_queued
+//
+/* Marks the work for a function and argument pair queued on the lanes as cancelled. Entries
+ * cannot be changed once they are queued, so a tombstone records the pair and the current
+ * cancel epoch, and the worker drops matching work of that epoch or earlier when it takes it.
+ * Nothing is marked if all tombstones are in use.
+ * @param   worker    : pointer to @ref cy_worker_thread_info_t
+ * @param   work_func : function of the work to cancel
+ * @param   arg       : argument of the work to cancel
+ * @return  CY_RSLT_SUCCESS if the lanes are empty, CY_WORKER_THREAD_CANCEL_PENDING if the
+ *          tombstone was set or CY_WORKER_THREAD_ERR_CANCEL_BUSY if no tombstone is free
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_cancel_queued(cy_worker_thread_info_t* worker,
+                                                cy_worker_thread_func_t* work_func, void* arg)
+{
+    // Work queued once the lanes have been seen empty was queued after this call
+    if (cy_worker_thread_busy_lanes(worker) == 0)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    #if (CY_WORKER_THREAD_MAX_CANCEL > 0)
+    cy_worker_tombstone_t* tombstone = NULL;
+    for (uint32_t i = 0; (tombstone == NULL) && (i < CY_WORKER_THREAD_MAX_CANCEL); i++)
+    {
+        if (cy_rtos_atomic_cas(&worker->tombstones[i].lanes, 0, CY_WORKER_TOMBSTONE_CLAIMED))
+        {
+            tombstone = &worker->tombstones[i];
+        }
+    }
+    if (tombstone == NULL)
+    {
+        return CY_WORKER_THREAD_ERR_CANCEL_BUSY;
+    }
+
+    // Work queued from here on gets the new epoch and is left alone
+    tombstone->work_func = work_func;
+    tombstone->arg       = arg;
+    tombstone->epoch     = cy_rtos_atomic_add(&worker->cancel_epoch, 1) - 1U;
+
+    // Publishes the tombstone, or frees it again if the worker emptied the lanes meanwhile
+    uint32_t lanes = cy_worker_thread_busy_lanes(worker);
+    (void)cy_rtos_atomic_cas(&tombstone->lanes, CY_WORKER_TOMBSTONE_CLAIMED, lanes);
+    if (lanes == 0)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    // The worker may have emptied the lanes and blocked before it saw the tombstone, the
+    // wakeup has it retire the tombstone
+    cy_worker_thread_wake(worker);
+    return CY_WORKER_THREAD_CANCEL_PENDING;
+    #else
+    CY_UNUSED_PARAMETER(work_func);
+    CY_UNUSED_PARAMETER(arg);
+    return CY_WORKER_THREAD_ERR_CANCEL_BUSY;
+    #endif // (CY_WORKER_THREAD_MAX_CANCEL > 0)
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_cancel
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_cancel(cy_worker_thread_info_t* worker_info,
+                                  cy_worker_thread_func_t* work_func, void* arg)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(work_func != NULL);
+    CY_ASSERT(!is_in_isr());
+
+    // The pool threads check the tombstones independently, so none could tell when a lane
+    // has been passed
+    if (worker_info->pooled)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    // Work queued with a payload is passed its payload instead of an arg that could be matched
+    if (worker_info->payload_size != 0)
+    {
+        return CY_RTOS_UNSUPPORTED;
+    }
+
+    // Keeps the worker from being deleted while its queues are searched
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    // Nothing is removed unless the work on the lanes can be marked as well
+    result = cy_worker_thread_cancel_queued(worker_info, work_func, arg);
+    if (result != CY_WORKER_THREAD_ERR_CANCEL_BUSY)
+    {
+        uint32_t removed = cy_worker_thread_cancel_items(worker_info, work_func, arg);
+        if (worker_info->delayed_count != 0)
+        {
+            removed += cy_worker_thread_cancel_timed(
+                (cy_worker_timed_info_t*)worker_info->delayed, &worker_info->delayed_count,
+                worker_info->delayed_size, work_func, arg);
+        }
+        if (worker_info->deadline_count != 0)
+        {
+            removed += cy_worker_thread_cancel_timed(
+                (cy_worker_timed_info_t*)worker_info->deadline, &worker_info->deadline_count,
+                worker_info->deadline_size, work_func, arg);
+        }
+        if (worker_info->deferred_count != 0)
+        {
+            removed += cy_worker_thread_cancel_timed(
+                (cy_worker_timed_info_t*)worker_info->deferred, &worker_info->deferred_count,
+                worker_info->deferred_size, work_func, arg);
+        }
+        CY_WORKER_STATS_ADD(worker_info, cancelled, removed);
+
+        if ((result == CY_RSLT_SUCCESS) && (removed == 0))
+        {
+            result = CY_WORKER_THREAD_ERR_NOT_FOUND;
+        }
+    }
+
+    cy_worker_thread_enqueue_end(worker_info);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_flush
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_flush(cy_worker_thread_info_t* worker_info, cy_time_t timeout_ms)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(!is_in_isr());
+
+    // Another pool thread may still be running work queued before the marker
+    if (worker_info->pooled)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    // Sequence number 0 is reserved for waiting on a pause
+    uint32_t seq;
+    do
+    {
+        seq = cy_rtos_atomic_add(&worker_info->flush_seq, 1);
+    } while (seq == 0);
+
+    // The marker is queued behind all earlier work regardless of the overflow policy
+    cy_time_t start;
+    cy_rtos_time_get(&start);
+    void*             seq_arg = (void*)(uintptr_t)seq;
+    cy_worker_entry_t marker  = { .dispatch_info.work_func = cy_worker_thread_flush_marker,
+                                  .dispatch_info.arg       = seq_arg };
+    cy_worker_entry_set_epoch(worker_info, &marker);
+    result = cy_rtos_queue_put(&worker_info->event_queue, &marker, timeout_ms);
+    cy_worker_thread_enqueue_end(worker_info);
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        cy_time_t remaining = timeout_ms;
+        if (timeout_ms != CY_RTOS_NEVER_TIMEOUT)
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            remaining = ((now - start) < timeout_ms) ? (timeout_ms - (now - start)) : 0;
+        }
+        result = cy_worker_thread_wait(worker_info, seq, remaining);
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_pause
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_pause(cy_worker_thread_info_t* worker_info, cy_time_t timeout_ms)
+{
+    CY_ASSERT(worker_info != NULL);
+    CY_ASSERT(!is_in_isr());
+
+    if (worker_info->pooled)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    worker_info->paused = 1;
+    // A worker blocked waiting for work has to wake up to notice
+    cy_worker_thread_wake(worker_info);
+    cy_worker_thread_enqueue_end(worker_info);
+
+    return cy_worker_thread_wait(worker_info, 0, timeout_ms);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_resume
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_resume(cy_worker_thread_info_t* worker_info)
+{
+    CY_ASSERT(worker_info != NULL);
+
+    if (worker_info->pooled)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        worker_info->paused = 0;
+        result = cy_rtos_thread_set_notification(&worker_info->thread);
+        cy_worker_thread_enqueue_end(worker_info);
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_stats
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_get_stats(cy_worker_thread_info_t* worker_info,
+                                     cy_worker_thread_stats_t* stats)
+{
+    CY_ASSERT((worker_info != NULL) && (stats != NULL));
+
+    #if !defined(CY_WORKER_THREAD_ENABLE_STATS)
+    CY_UNUSED_PARAMETER(worker_info);
+    CY_UNUSED_PARAMETER(stats);
+    return CY_RTOS_UNSUPPORTED;
+    #else
+    uint32_t state = cyhal_system_critical_section_enter();
+    if (worker_info->state == CY_WORKER_THREAD_INVALID)
+    {
+        cyhal_system_critical_section_exit(state);
+        return CY_WORKER_THREAD_ERR_THREAD_INVALID;
+    }
+    *stats = worker_info->stats;
+    cyhal_system_critical_section_exit(state);
+    return CY_RSLT_SUCCESS;
+    #endif // !defined(CY_WORKER_THREAD_ENABLE_STATS)
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_create
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_pool_create(cy_worker_pool_t* new_pool, const cy_worker_pool_params_t* params)
+{
+    // Param check
+    CY_ASSERT((params != NULL) && (new_pool != NULL));
+    const cy_worker_thread_params_t* thread_params = &params->thread_params;
+    CY_ASSERT((thread_params->stack == NULL) ||
+              ((thread_params->stack != NULL) && (thread_params->stack_size != 0)));
+
+    uint32_t num_threads = (params->num_threads != 0)
+        ? params->num_threads
+        : CY_WORKER_POOL_DEFAULT_THREADS;
+    uint32_t max_threads = (params->max_threads > num_threads)
+        ? params->max_threads
+        : num_threads;
+    if ((max_threads > CY_WORKER_POOL_MAX_THREADS) || (thread_params->thread_cb != NULL) ||
+        ((max_threads != num_threads) && (params->mode == CY_WORKER_POOL_WORK_STEALING)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    #if !defined(CY_WORKER_THREAD_ENABLE_STATS)
+    // Work is not stamped with the time it was queued
+    if (params->grow_latency_ms != 0)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    #endif
+
+    // Start with a clean structure
+    memset(new_pool, 0, sizeof(cy_worker_pool_t));
+    cy_worker_thread_info_t* worker = &new_pool->worker;
+    worker->enqueue_count = CY_WORKER_THREAD_CLOSED;
+    worker->pooled        = true;
+    worker->stealing      = (params->mode == CY_WORKER_POOL_WORK_STEALING);
+    new_pool->mode = params->mode;
+
+    // Threads added later are started from the stored parameters
+    new_pool->params                    = *params;
+    new_pool->params.num_threads        = num_threads;
+    new_pool->params.max_threads        = max_threads;
+    new_pool->params.thread_params.name = (thread_params->name != NULL)
+        ? thread_params->name
+        : CY_WORKER_THREAD_DEFAULT_NAME;
+    if (new_pool->params.idle_timeout_ms == 0)
+    {
+        new_pool->params.idle_timeout_ms = CY_WORKER_POOL_DEFAULT_IDLE_MS;
+    }
+    if (max_threads != num_threads)
+    {
+        worker->pool = new_pool;
+    }
+
+    uint32_t  num_entries = (thread_params->num_entries != 0)
+        ? thread_params->num_entries
+        : CY_WORKER_DEFAULT_ENTRIES;
+    cy_rslt_t result      = CY_RSLT_SUCCESS;
+    if (params->mode == CY_WORKER_POOL_WORK_STEALING)
+    {
+        cy_worker_dispatch_info_t* entries = (cy_worker_dispatch_info_t*)malloc(
+            num_threads * num_entries * sizeof(cy_worker_dispatch_info_t));
+        if (entries == NULL)
+        {
+            result = CY_RTOS_NO_MEMORY;
+        }
+        for (uint32_t i = 0; (i < num_threads) && (result == CY_RSLT_SUCCESS); i++)
+        {
+            new_pool->deques[i].pool    = new_pool;
+            new_pool->deques[i].entries = &entries[i * num_entries];
+            new_pool->deques[i].size    = num_entries;
+        }
+    }
+    else
+    {
+        result = cy_worker_thread_queues_init(worker, thread_params);
+    }
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        // Each thread gets its own aligned slice of a caller provided stack buffer
+        uint32_t stack_slice = thread_params->stack_size & ~CY_RTOS_ALIGNMENT_MASK;
+        worker->state         = CY_WORKER_THREAD_VALID;
+        worker->enqueue_count = 0;
+        while ((new_pool->num_threads < num_threads) && (result == CY_RSLT_SUCCESS))
+        {
+            uint8_t* stack = (thread_params->stack != NULL)
+                ? &thread_params->stack[new_pool->num_threads * stack_slice]
+                : NULL;
+            bool stealing = (params->mode == CY_WORKER_POOL_WORK_STEALING);
+            cy_thread_arg_t thread_arg = stealing
+                ? (cy_thread_arg_t)&new_pool->deques[new_pool->num_threads]
+                : (cy_thread_arg_t)worker;
+            result = cy_rtos_thread_create(&new_pool->threads[new_pool->num_threads],
+                                           stealing
+                                           ? cy_worker_pool_stealing_func
+                                           : cy_worker_thread_func,
+                                           new_pool->params.thread_params.name,
+                                           stack,
+                                           thread_params->stack_size,
+                                           thread_params->priority,
+                                           thread_arg);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                new_pool->live |= (1UL << new_pool->num_threads);
+                new_pool->num_threads++;
+            }
+        }
+
+        if (result != CY_RSLT_SUCCESS)
+        {
+            // Tear down the threads that did start. Nothing has been queued yet so the
+            // terminating events always fit.
+            cy_worker_pool_delete(new_pool);
+            new_pool->num_threads = 0;
+            new_pool->live        = 0;
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_delete
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_pool_delete(cy_worker_pool_t* old_pool)
+{
+    CY_ASSERT(old_pool != NULL);
+    return (old_pool->mode == CY_WORKER_POOL_WORK_STEALING)
+        ? cy_worker_pool_stealing_stop(old_pool)
+        : cy_worker_thread_stop(&old_pool->worker, old_pool->threads, &old_pool->live,
+                                &old_pool->retired);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_pool_enqueue
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_pool_enqueue(cy_worker_pool_t* pool, cy_worker_thread_func_t* work_func,
+                                 void* arg)
+{
+    CY_ASSERT(pool != NULL);
+    CY_ASSERT(work_func != NULL);
+    return (pool->mode == CY_WORKER_POOL_WORK_STEALING)
+        ? cy_worker_pool_stealing_enqueue(pool, work_func, arg)
+        : cy_worker_thread_enqueue(&pool->worker, work_func, arg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_queue
+//
+/* Queues a stage whose predecessors have all finished. The event queue spreads stages across
+ * the threads of a pool; if it is full the stage's work item is used, which cannot overflow.
+ * A failure is recorded as the result of the run unless an earlier one was.
+ * @param   graph : graph the stage belongs to
+ * @param   stage : stage to queue
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_graph_queue(cy_worker_graph_t* graph, cy_worker_stage_t* stage)
+{
+    cy_rslt_t result = cy_worker_thread_enqueue(graph->worker, stage->item.work_func, stage);
+    if (result == CY_RTOS_QUEUE_FULL)
+    {
+        result = cy_worker_thread_enqueue_item(graph->worker, &stage->item);
+    }
+    if (result != CY_RSLT_SUCCESS)
+    {
+        (void)cy_rtos_atomic_cas((volatile uint32_t*)&graph->result, CY_RSLT_SUCCESS, result);
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_finish
+//
+/* Ends a stage that ran, or that is skipped because the run failed. Each successor that this
+ * was the last unfinished predecessor of is queued, or skipped as well once the run has
+ * failed, and the run is marked done after its last stage. Skipped stages are not queued, so
+ * their work items are free to link them into a list, which avoids recursion.
+ * @param   graph : graph the stage belongs to
+ * @param   stage : stage that ended
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_graph_finish(cy_worker_graph_t* graph, cy_worker_stage_t* stage)
+{
+    cy_work_item_t* skipped = NULL;
+    while (stage != NULL)
+    {
+        for (uint32_t i = 0; i < stage->num_successors; i++)
+        {
+            cy_worker_stage_t* successor = stage->successors[i];
+            if ((cy_rtos_atomic_add(&successor->remaining, (uint32_t)-1) == 0) &&
+                ((graph->result != CY_RSLT_SUCCESS) ||
+                 (cy_worker_graph_queue(graph, successor) != CY_RSLT_SUCCESS)))
+            {
+                successor->item.next = skipped;
+                skipped              = &successor->item;
+            }
+        }
+
+        // Skipped stages still count, so the run cannot be done while any are left
+        if (cy_rtos_atomic_add(&graph->remaining, (uint32_t)-1) == 0)
+        {
+            cy_worker_completion_signal(&graph->done);
+        }
+
+        // The work item is the first member of a stage
+        stage = (cy_worker_stage_t*)skipped;
+        if (skipped != NULL)
+        {
+            skipped = skipped->next;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_stage_func
+//
+/* Runs a stage, then ends it with @ref cy_worker_graph_finish.
+ * @param   arg : pointer to @ref cy_worker_stage_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_graph_stage_func(void* arg)
+{
+    cy_worker_stage_t* stage = (cy_worker_stage_t*)arg;
+
+    stage->work_func(stage->arg);
+    cy_worker_graph_finish((cy_worker_graph_t*)stage->graph, stage);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_reaches
+//
+/* Checks whether a stage depends, directly or not, on another one. The remaining counts are
+ * only used during a run, so they mark the stages found to depend on from meanwhile.
+ * @param   graph : graph of both stages
+ * @param   from  : stage the search starts at
+ * @param   to    : stage to look for
+ * @return  true if to is from or runs after it
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_graph_reaches(cy_worker_graph_t* graph, cy_worker_stage_t* from,
+                                    cy_worker_stage_t* to)
+{
+    for (cy_worker_stage_t* stage = graph->stages; stage != NULL; stage = stage->next)
+    {
+        stage->remaining = 0;
+    }
+    from->remaining = 1;
+
+    // Each pass marks the successors of the marked stages until no more are found
+    bool changed = true;
+    while (changed && (to->remaining == 0))
+    {
+        changed = false;
+        for (cy_worker_stage_t* stage = graph->stages; stage != NULL; stage = stage->next)
+        {
+            for (uint32_t i = 0; (stage->remaining != 0) && (i < stage->num_successors); i++)
+            {
+                if (stage->successors[i]->remaining == 0)
+                {
+                    stage->successors[i]->remaining = 1;
+                    changed                         = true;
+                }
+            }
+        }
+    }
+    return (to->remaining != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_graph_init(cy_worker_graph_t* graph, cy_worker_thread_info_t* worker_info)
+{
+    CY_ASSERT((graph != NULL) && (worker_info != NULL));
+
+    memset(graph, 0, sizeof(cy_worker_graph_t));
+    graph->done.state = CY_WORKER_COMPLETION_DONE;
+
+    // Refuses the worker of a work-stealing pool and a deleted worker
+    cy_rslt_t result = cy_worker_thread_enqueue_begin(worker_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    cy_worker_thread_enqueue_end(worker_info);
+
+    // Any other policy can drop a stage, or another one that is already queued
+    if (worker_info->overflow != CY_WORKER_THREAD_OVERFLOW_FAIL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    graph->worker = worker_info;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_add_stage
+//--------------------------------------------------------------------------------------------------
+void cy_worker_graph_add_stage(cy_worker_graph_t* graph, cy_worker_stage_t* stage,
+                               cy_worker_thread_func_t* work_func, void* arg)
+{
+    CY_ASSERT((graph != NULL) && (stage != NULL) && (work_func != NULL));
+    CY_ASSERT(cy_worker_graph_is_done(graph));
+
+    memset(stage, 0, sizeof(cy_worker_stage_t));
+    cy_work_item_init(&stage->item, cy_worker_graph_stage_func, stage);
+    stage->work_func = work_func;
+    stage->arg       = arg;
+    stage->graph     = graph;
+    stage->next      = graph->stages;
+    graph->stages    = stage;
+    graph->num_stages++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_add_dependency
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_graph_add_dependency(cy_worker_stage_t* stage,
+                                         cy_worker_stage_t* predecessor)
+{
+    CY_ASSERT((stage != NULL) && (predecessor != NULL));
+    CY_ASSERT(cy_worker_graph_is_done((cy_worker_graph_t*)stage->graph));
+
+    if ((stage->graph != predecessor->graph) ||
+        (predecessor->num_successors == CY_WORKER_GRAPH_MAX_SUCCESSORS) ||
+        cy_worker_graph_reaches((cy_worker_graph_t*)stage->graph, stage, predecessor))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    predecessor->successors[predecessor->num_successors++] = stage;
+    stage->num_predecessors++;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_run
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_graph_run(cy_worker_graph_t* graph)
+{
+    CY_ASSERT(graph != NULL);
+
+    if ((graph->worker == NULL) || !cy_worker_graph_is_done(graph))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if (graph->num_stages == 0)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    // Everything is reset before the first stage is queued, since stages may finish right away
+    for (cy_worker_stage_t* stage = graph->stages; stage != NULL; stage = stage->next)
+    {
+        stage->remaining = stage->num_predecessors;
+    }
+    graph->remaining   = graph->num_stages;
+    graph->result      = CY_RSLT_SUCCESS;
+    graph->done.waiter = NULL;
+    graph->done.state  = 0;
+
+    // Once a stage could not be queued the remaining ones are skipped, which ends the run. The
+    // roots still to be queued keep the run from ending meanwhile.
+    cy_rslt_t          result = CY_RSLT_SUCCESS;
+    cy_worker_stage_t* next;
+    for (cy_worker_stage_t* stage = graph->stages; stage != NULL; stage = next)
+    {
+        next = stage->next;
+        if (stage->num_predecessors == 0)
+        {
+            if (result == CY_RSLT_SUCCESS)
+            {
+                result = cy_worker_graph_queue(graph, stage);
+            }
+            if (result != CY_RSLT_SUCCESS)
+            {
+                cy_worker_graph_finish(graph, stage);
+            }
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_wait
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_graph_wait(cy_worker_graph_t* graph, cy_time_t timeout_ms)
+{
+    CY_ASSERT(graph != NULL);
+    cy_rslt_t result = cy_worker_completion_wait(&graph->done, timeout_ms);
+    return (result == CY_RSLT_SUCCESS) ? graph->result : result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_graph_is_done
+//--------------------------------------------------------------------------------------------------
+bool cy_worker_graph_is_done(const cy_worker_graph_t* graph)
+{
+    CY_ASSERT(graph != NULL);
+    return cy_worker_completion_is_done(&graph->done);
 }
 
 
@@ -0,0 +1,306 @@
+/***********************************************************************************************//**
+ * \file cyabs_rtos_mpmc_queue.c
+ *
+ * \brief
+ * Provides implementation for bounded lock-free multiple producer, multiple consumer queues that
+ * only use the RTOS to block consumers.
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2018-2022 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cyabs_rtos.h"
+#include "cyabs_rtos_internal.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+// Maximum count of the semaphore that wakes consumers. RTX limits semaphores to 65535 tokens.
+#define CY_RTOS_MPMC_MAX_WAKEUPS    (0xFFFFU)
+
+// Each cell starts with its sequence number. A cell can be written by the producer that reserves
+// position pos once its sequence is pos, and read by the consumer that reserves position pos once
+// its sequence is pos + 1. The consumer then moves it on to pos + length for the next lap.
+#define CY_RTOS_MPMC_SEQ(cell)      (*(volatile uint32_t*)(cell))
+#define CY_RTOS_MPMC_ITEM(cell)     ((cell) + CY_RTOS_ALIGNMENT)
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_take
+//
+/* Takes the oldest item without waiting.
+ * @param   queue    : pointer to @ref cy_mpmc_queue_t
+ * @param   item_ptr : memory for the item
+ * @return  true if an item was taken
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_rtos_mpmc_queue_take(cy_mpmc_queue_t* queue, void* item_ptr)
+{
+    uint32_t pos = queue->get_pos;
+    while (true)
+    {
+        uint8_t* cell = &queue->cells[(pos & queue->mask) * queue->cell_size];
+        int32_t  diff = (int32_t)(CY_RTOS_MPMC_SEQ(cell) - (pos + 1U));
+        if (diff < 0)
+        {
+            return false;
+        }
+        if ((diff == 0) && cy_rtos_atomic_cas(&queue->get_pos, pos, pos + 1U))
+        {
+            // The item is read after its sequence showed it was written, and before the cell
+            // is handed back to the producers
+            cy_rtos_memory_barrier();
+            memcpy(item_ptr, CY_RTOS_MPMC_ITEM(cell), queue->itemsize);
+            cy_rtos_memory_barrier();
+            CY_RTOS_MPMC_SEQ(cell) = pos + queue->mask + 1U;
+            return true;
+        }
+        // Another consumer took this position first
+        pos = queue->get_pos;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_claim_waiter
+//
+/* Takes one consumer off the count of waiting consumers. A consumer that stops waiting may find
+ * that a producer already took it off, in which case the semaphore token given by the producer
+ * wakes another consumer or makes a later wait return early, which only costs a retry.
+ * @param   queue : pointer to @ref cy_mpmc_queue_t
+ * @return  true if a waiting consumer was counted
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_rtos_mpmc_queue_claim_waiter(cy_mpmc_queue_t* queue)
+{
+    uint32_t waiters;
+    do
+    {
+        waiters = queue->waiters;
+    } while ((waiters != 0) && !cy_rtos_atomic_cas(&queue->waiters, waiters, waiters - 1U));
+    return (waiters != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mpmc_queue_init_static(cy_mpmc_queue_t* queue, size_t length, size_t itemsize,
+                                         void* storage)
+{
+    // The free running positions only wrap correctly for power of 2 lengths
+    if ((queue == NULL) || (storage == NULL) || (length < 2) || (itemsize == 0) ||
+        ((length & (length - 1U)) != 0U) || (length > 0x80000000U))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if (0 != (((uintptr_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        return CY_RTOS_ALIGNMENT_ERROR;
+    }
+
+    cy_rslt_t result = cy_rtos_semaphore_init(&queue->items, CY_RTOS_MPMC_MAX_WAKEUPS, 0);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    queue->cells     = (uint8_t*)storage;
+    queue->mem       = NULL;
+    queue->mask      = (uint32_t)length - 1U;
+    queue->cell_size = CY_RTOS_MPMC_CELL_SIZE(itemsize);
+    queue->itemsize  = (uint32_t)itemsize;
+    queue->put_pos   = 0;
+    queue->get_pos   = 0;
+    queue->waiters   = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        CY_RTOS_MPMC_SEQ(&queue->cells[i * queue->cell_size]) = i;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mpmc_queue_init(cy_mpmc_queue_t* queue, size_t length, size_t itemsize)
+{
+    if ((queue == NULL) || (length == 0) || (itemsize == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    void* mem = malloc(CY_RTOS_MPMC_QUEUE_STORAGE_SIZE(length, itemsize));
+    if (mem == NULL)
+    {
+        return CY_RTOS_NO_MEMORY;
+    }
+
+    cy_rslt_t result = cy_rtos_mpmc_queue_init_static(queue, length, itemsize, mem);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        free(mem);
+        return result;
+    }
+    queue->mem = mem;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_put
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mpmc_queue_put(cy_mpmc_queue_t* queue, const void* item_ptr)
+{
+    if ((queue == NULL) || (item_ptr == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t pos = queue->put_pos;
+    uint8_t* cell;
+    while (true)
+    {
+        cell = &queue->cells[(pos & queue->mask) * queue->cell_size];
+        int32_t diff = (int32_t)(CY_RTOS_MPMC_SEQ(cell) - pos);
+        if (diff < 0)
+        {
+            // The cell still holds the item of the previous lap
+            return CY_RTOS_QUEUE_FULL;
+        }
+        if ((diff == 0) && cy_rtos_atomic_cas(&queue->put_pos, pos, pos + 1U))
+        {
+            break;
+        }
+        // Another producer took this position first
+        pos = queue->put_pos;
+    }
+
+    // The consumer of the previous lap is done with the cell before it is written, and the item
+    // is written before consumers can see it
+    cy_rtos_memory_barrier();
+    memcpy(CY_RTOS_MPMC_ITEM(cell), item_ptr, queue->itemsize);
+    cy_rtos_memory_barrier();
+    CY_RTOS_MPMC_SEQ(cell) = pos + 1U;
+
+    // Consumers count themselves as waiting before they check for items a last time, so either
+    // they see this item or this sees them
+    cy_rtos_memory_barrier();
+    if (cy_rtos_mpmc_queue_claim_waiter(queue))
+    {
+        (void)cy_rtos_semaphore_set(&queue->items);
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_get
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mpmc_queue_get(cy_mpmc_queue_t* queue, void* item_ptr, cy_time_t timeout_ms)
+{
+    if ((queue == NULL) || (item_ptr == NULL) || (is_in_isr() && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    if (cy_rtos_mpmc_queue_take(queue, item_ptr))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    cy_time_t start;
+    cy_rtos_time_get(&start);
+    cy_time_t remaining = timeout_ms;
+    while (remaining != 0)
+    {
+        (void)cy_rtos_atomic_add(&queue->waiters, 1);
+        if (cy_rtos_mpmc_queue_take(queue, item_ptr))
+        {
+            (void)cy_rtos_mpmc_queue_claim_waiter(queue);
+            return CY_RSLT_SUCCESS;
+        }
+
+        // A producer takes the consumer off the count when it gives the semaphore
+        if (cy_rtos_semaphore_get(&queue->items, remaining) != CY_RSLT_SUCCESS)
+        {
+            (void)cy_rtos_mpmc_queue_claim_waiter(queue);
+        }
+        // Other consumers can take the item first
+        if (cy_rtos_mpmc_queue_take(queue, item_ptr))
+        {
+            return CY_RSLT_SUCCESS;
+        }
+
+        if (timeout_ms != CY_RTOS_NEVER_TIMEOUT)
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            cy_time_t elapsed = now - start;
+            remaining = (elapsed >= timeout_ms) ? 0 : (timeout_ms - elapsed);
+        }
+    }
+    return CY_RTOS_QUEUE_EMPTY;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mpmc_queue_count(cy_mpmc_queue_t* queue, size_t* num_waiting)
+{
+    if ((queue == NULL) || (num_waiting == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    uint32_t get_pos = queue->get_pos;
+    uint32_t count   = queue->put_pos - get_pos;
+    *num_waiting = (count > (queue->mask + 1U)) ? 0 : count;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mpmc_queue_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mpmc_queue_deinit(cy_mpmc_queue_t* queue)
+{
+    if (queue == NULL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    cy_rslt_t result = cy_rtos_semaphore_deinit(&queue->items);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        free(queue->mem);
+        queue->mem   = NULL;
+        queue->cells = NULL;
+    }
+    return result;
+}
+
+
+#if defined(__cplusplus)
+}
+#endif
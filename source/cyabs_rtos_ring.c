@@ -0,0 +1,295 @@
+/***********************************************************************************************//**
+ * \file cyabs_rtos_ring.c
+ *
+ * \brief
+ * Provides implementation for single producer, single consumer rings that can be fed from an
+ * ISR without masking interrupts.
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2018-2022 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cyabs_rtos.h"
+#include "cyabs_rtos_internal.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_copy_in
+//
+/* Copies items into the ring, wrapping around the end of the item memory.
+ * @param   ring  : pointer to @ref cy_ring_t
+ * @param   index : free running index of the first item
+ * @param   items : items to copy
+ * @param   count : number of items
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_rtos_ring_copy_in(cy_ring_t* ring, uint32_t index, const uint8_t* items,
+                                 uint32_t count)
+{
+    uint32_t start = index & (ring->length - 1U);
+    uint32_t first = ((ring->length - start) < count) ? (ring->length - start) : count;
+    memcpy(&ring->buffer[start * ring->itemsize], items, first * ring->itemsize);
+    memcpy(ring->buffer, &items[first * ring->itemsize], (count - first) * ring->itemsize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_copy_out
+//
+/* Copies items out of the ring, wrapping around the end of the item memory.
+ * @param   ring  : pointer to @ref cy_ring_t
+ * @param   index : free running index of the first item
+ * @param   items : memory for the items
+ * @param   count : number of items
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_rtos_ring_copy_out(const cy_ring_t* ring, uint32_t index, uint8_t* items,
+                                  uint32_t count)
+{
+    uint32_t start = index & (ring->length - 1U);
+    uint32_t first = ((ring->length - start) < count) ? (ring->length - start) : count;
+    memcpy(items, &ring->buffer[start * ring->itemsize], first * ring->itemsize);
+    memcpy(&items[first * ring->itemsize], ring->buffer, (count - first) * ring->itemsize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_wait
+//
+/* Blocks the consumer until the ring holds items or the timeout expires.
+ * @param   ring       : pointer to @ref cy_ring_t
+ * @param   tail       : tail of the ring, which only the caller changes
+ * @param   timeout_ms : maximum time to wait
+ * @return  head of the ring, equal to tail if no item was put in time
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_rtos_ring_wait(cy_ring_t* ring, uint32_t tail, cy_time_t timeout_ms)
+{
+    if (cy_rtos_thread_get_handle(&ring->consumer) != CY_RSLT_SUCCESS)
+    {
+        return tail;
+    }
+    // The handle is written before the producer can see waiting set
+    cy_rtos_memory_barrier();
+
+    cy_time_t start;
+    cy_rtos_time_get(&start);
+    cy_time_t remaining = timeout_ms;
+    uint32_t  head;
+    while (true)
+    {
+        // The producer stores head before it reads waiting, and the consumer stores waiting
+        // before it reads head, so at least one of them sees the other and no wakeup is lost
+        ring->waiting = true;
+        cy_rtos_memory_barrier();
+        head = ring->head;
+        if (head != tail)
+        {
+            break;
+        }
+
+        // Notifications for items that were already taken can wake the thread early
+        (void)cy_rtos_thread_wait_notification(remaining);
+        if (timeout_ms != CY_RTOS_NEVER_TIMEOUT)
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            cy_time_t elapsed = now - start;
+            if (elapsed >= timeout_ms)
+            {
+                head = ring->head;
+                break;
+            }
+            remaining = timeout_ms - elapsed;
+        }
+    }
+    ring->waiting = false;
+    return head;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_ring_init_static(cy_ring_t* ring, size_t length, size_t itemsize,
+                                   void* storage)
+{
+    // The free running indexes only wrap correctly for power of 2 lengths
+    if ((ring == NULL) || (storage == NULL) || (length == 0) || (itemsize == 0) ||
+        ((length & (length - 1U)) != 0U) || (length > 0x80000000U))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    ring->buffer   = (uint8_t*)storage;
+    ring->mem      = NULL;
+    ring->length   = (uint32_t)length;
+    ring->itemsize = (uint32_t)itemsize;
+    ring->head     = 0;
+    ring->tail     = 0;
+    ring->waiting  = false;
+    ring->consumer = NULL;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_ring_init(cy_ring_t* ring, size_t length, size_t itemsize)
+{
+    if ((ring == NULL) || (length == 0) || (itemsize == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    void* mem = malloc(CY_RTOS_RING_STORAGE_SIZE(length, itemsize));
+    if (mem == NULL)
+    {
+        return CY_RTOS_NO_MEMORY;
+    }
+
+    cy_rslt_t result = cy_rtos_ring_init_static(ring, length, itemsize, mem);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        free(mem);
+        return result;
+    }
+    ring->mem = mem;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_put
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_ring_put(cy_ring_t* ring, const void* items, size_t num_items,
+                           size_t* num_put)
+{
+    if ((ring == NULL) || (items == NULL) || (num_items == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t head  = ring->head;
+    uint32_t space = ring->length - (head - ring->tail);
+    uint32_t count = (space < num_items) ? space : (uint32_t)num_items;
+    if (num_put != NULL)
+    {
+        *num_put = count;
+    }
+    if (count == 0)
+    {
+        return CY_RTOS_QUEUE_FULL;
+    }
+
+    // The consumer is done with the slots it released before they are written, and the items
+    // are written before the consumer can see them
+    cy_rtos_memory_barrier();
+    cy_rtos_ring_copy_in(ring, head, (const uint8_t*)items, count);
+    cy_rtos_memory_barrier();
+    ring->head = head + count;
+
+    cy_rtos_memory_barrier();
+    if (ring->waiting)
+    {
+        ring->waiting = false;
+        (void)cy_rtos_thread_set_notification(&ring->consumer);
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_get
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_ring_get(cy_ring_t* ring, void* items, size_t num_items, size_t* num_got,
+                           cy_time_t timeout_ms)
+{
+    if ((ring == NULL) || (items == NULL) || (num_items == 0) ||
+        (is_in_isr() && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t tail = ring->tail;
+    uint32_t head = ring->head;
+    if ((head == tail) && (timeout_ms != 0))
+    {
+        head = cy_rtos_ring_wait(ring, tail, timeout_ms);
+    }
+    uint32_t count = ((head - tail) < num_items) ? (head - tail) : (uint32_t)num_items;
+    if (num_got != NULL)
+    {
+        *num_got = count;
+    }
+    if (count == 0)
+    {
+        return CY_RTOS_QUEUE_EMPTY;
+    }
+
+    // The items are read after head showed they were written, and before their slots are
+    // released to the producer
+    cy_rtos_memory_barrier();
+    cy_rtos_ring_copy_out(ring, tail, (uint8_t*)items, count);
+    cy_rtos_memory_barrier();
+    ring->tail = tail + count;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_ring_count(cy_ring_t* ring, size_t* num_waiting)
+{
+    if ((ring == NULL) || (num_waiting == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    *num_waiting = ring->head - ring->tail;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_ring_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_ring_deinit(cy_ring_t* ring)
+{
+    if (ring == NULL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    free(ring->mem);
+    ring->mem    = NULL;
+    ring->buffer = NULL;
+    return CY_RSLT_SUCCESS;
+}
+
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,247 @@
+/***********************************************************************************************//**
+ * \file cyabs_rtos_slot_queue.c
+ *
+ * \brief
+ * Provides implementation for queues whose items are built and consumed in place, on top of
+ * the RTOS queue abstraction.
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2018-2022 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#include <stdlib.h>
+
+#include "cyabs_rtos.h"
+#include "cy_utils.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+// Bytes taken by each of the two queues of slot pointers at the start of the storage
+#define CY_RTOS_SLOT_QUEUE_REGION_SIZE(length) \
+    ((CY_RTOS_QUEUE_STORAGE_SIZE((length), sizeof(void*)) + CY_RTOS_ALIGNMENT_MASK) & \
+     ~CY_RTOS_ALIGNMENT_MASK)
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_start
+//
+/* Creates the queues of a slot queue in storage and marks every slot free.
+ * @param   queue    : pointer to @ref cy_slot_queue_t
+ * @param   length   : number of slots
+ * @param   itemsize : size of each item
+ * @param   storage  : memory of @ref CY_RTOS_SLOT_QUEUE_STORAGE_SIZE bytes
+ * @return  the status of the init
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_rtos_slot_queue_start(cy_slot_queue_t* queue, size_t length, size_t itemsize,
+                                          uint8_t* storage)
+{
+    size_t    region = CY_RTOS_SLOT_QUEUE_REGION_SIZE(length);
+    cy_rslt_t result = cy_rtos_queue_init_static(&queue->free, length, sizeof(void*), storage);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    result = cy_rtos_queue_init_static(&queue->ready, length, sizeof(void*), storage + region);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        (void)cy_rtos_queue_deinit(&queue->free);
+        return result;
+    }
+
+    queue->slots     = storage + (2U * region);
+    queue->slot_size = CY_RTOS_SLOT_SIZE(itemsize);
+    queue->length    = length;
+    for (size_t i = 0; i < length; i++)
+    {
+        void* slot = (uint8_t*)queue->slots + (i * queue->slot_size);
+        result = cy_rtos_queue_put(&queue->free, &slot, 0);
+        CY_ASSERT(result == CY_RSLT_SUCCESS);
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_owns
+//
+/* Checks that slot is the start of one of the slots of queue.
+ * @param   queue : pointer to @ref cy_slot_queue_t
+ * @param   slot  : pointer to check
+ * @return  true if slot belongs to the queue
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_rtos_slot_queue_owns(const cy_slot_queue_t* queue, const void* slot)
+{
+    uintptr_t offset = (uintptr_t)slot - (uintptr_t)queue->slots;
+    return ((uintptr_t)slot >= (uintptr_t)queue->slots) &&
+           (offset < (queue->length * queue->slot_size)) &&
+           ((offset % queue->slot_size) == 0U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_init(cy_slot_queue_t* queue, size_t length, size_t itemsize)
+{
+    if ((queue == NULL) || (length == 0) || (itemsize == 0))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint8_t* mem = malloc(CY_RTOS_SLOT_QUEUE_STORAGE_SIZE(length, itemsize));
+    if (mem == NULL)
+    {
+        return CY_RTOS_NO_MEMORY;
+    }
+
+    cy_rslt_t result = cy_rtos_slot_queue_start(queue, length, itemsize, mem);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        free(mem);
+        return result;
+    }
+    queue->mem = mem;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_init_static(cy_slot_queue_t* queue, size_t length, size_t itemsize,
+                                         void* storage)
+{
+    if ((queue == NULL) || (length == 0) || (itemsize == 0) || (storage == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if (0 != (((uintptr_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        return CY_RTOS_ALIGNMENT_ERROR;
+    }
+
+    // The memory belongs to the caller, so deinit must not free it
+    queue->mem = NULL;
+    return cy_rtos_slot_queue_start(queue, length, itemsize, (uint8_t*)storage);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_reserve
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_reserve(cy_slot_queue_t* queue, void** slot, cy_time_t timeout_ms)
+{
+    if ((queue == NULL) || (slot == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    // The ports report an empty queue differently, no free slot means the queue is full
+    return (cy_rtos_queue_get(&queue->free, slot, timeout_ms) == CY_RSLT_SUCCESS)
+        ? CY_RSLT_SUCCESS
+        : CY_RTOS_QUEUE_FULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_commit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_commit(cy_slot_queue_t* queue, void* slot)
+{
+    if ((queue == NULL) || !cy_rtos_slot_queue_owns(queue, slot))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    // There are as many entries as slots, so this never waits
+    return cy_rtos_queue_put(&queue->ready, &slot, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_acquire
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_acquire(cy_slot_queue_t* queue, void** slot, cy_time_t timeout_ms)
+{
+    if ((queue == NULL) || (slot == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    return (cy_rtos_queue_get(&queue->ready, slot, timeout_ms) == CY_RSLT_SUCCESS)
+        ? CY_RSLT_SUCCESS
+        : CY_RTOS_QUEUE_EMPTY;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_release
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_release(cy_slot_queue_t* queue, void* slot)
+{
+    if ((queue == NULL) || !cy_rtos_slot_queue_owns(queue, slot))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    return cy_rtos_queue_put(&queue->free, &slot, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_count(cy_slot_queue_t* queue, size_t* num_waiting)
+{
+    if ((queue == NULL) || (num_waiting == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    return cy_rtos_queue_count(&queue->ready, num_waiting);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_slot_queue_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_slot_queue_deinit(cy_slot_queue_t* queue)
+{
+    if (queue == NULL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    cy_rslt_t result = cy_rtos_queue_deinit(&queue->ready);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cy_rtos_queue_deinit(&queue->free);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        free(queue->mem);
+        queue->mem   = NULL;
+        queue->slots = NULL;
+    }
+    return result;
+}
+
+
+#if defined(__cplusplus)
+}
+#endif
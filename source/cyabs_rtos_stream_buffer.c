@@ -0,0 +1,540 @@
+/***********************************************************************************************//**
+ * \file cyabs_rtos_stream_buffer.c
+ *
+ * \brief
+ * Provides implementation for stream and message buffers on RTOSes that do not have them. The
+ * bytes are kept in a ring shared by one writer and one reader, which only use the RTOS to block.
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2018-2022 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cyabs_rtos.h"
+#include "cyabs_rtos_internal.h"
+
+// Ports with native stream buffers implement this API on top of them
+#if !defined(CY_RTOS_NATIVE_STREAM_BUFFER)
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_used
+//
+/* Counts the bytes in the buffer.
+ * @param   buffer : pointer to @ref cy_stream_buffer_t
+ * @return  number of bytes written and not yet read
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_rtos_stream_buffer_used(const cy_stream_buffer_t* buffer)
+{
+    uint32_t head = buffer->head;
+    uint32_t tail = buffer->tail;
+    return (head >= tail) ? (head - tail) : (head + buffer->length - tail);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_free
+//
+/* Counts the bytes that can be written to the buffer.
+ * @param   buffer : pointer to @ref cy_stream_buffer_t
+ * @return  number of free bytes
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_rtos_stream_buffer_free(const cy_stream_buffer_t* buffer)
+{
+    // One byte is always left free so a full buffer can be told from an empty one
+    return buffer->length - 1U - cy_rtos_stream_buffer_used(buffer);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_copy_in
+//
+/* Copies bytes into the buffer, wrapping around the end of the byte memory.
+ * @param   buffer : pointer to @ref cy_stream_buffer_t
+ * @param   index  : index of the first byte
+ * @param   data   : bytes to copy
+ * @param   count  : number of bytes
+ * @return  index of the byte after the last one copied
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_rtos_stream_buffer_copy_in(cy_stream_buffer_t* buffer, uint32_t index,
+                                              const uint8_t* data, uint32_t count)
+{
+    uint32_t first = ((buffer->length - index) < count) ? (buffer->length - index) : count;
+    memcpy(&buffer->buffer[index], data, first);
+    memcpy(buffer->buffer, &data[first], count - first);
+    index += count;
+    return (index >= buffer->length) ? (index - buffer->length) : index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_copy_out
+//
+/* Copies bytes out of the buffer, wrapping around the end of the byte memory.
+ * @param   buffer : pointer to @ref cy_stream_buffer_t
+ * @param   index  : index of the first byte
+ * @param   data   : memory for the bytes
+ * @param   count  : number of bytes
+ * @return  index of the byte after the last one copied
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_rtos_stream_buffer_copy_out(const cy_stream_buffer_t* buffer, uint32_t index,
+                                               uint8_t* data, uint32_t count)
+{
+    uint32_t first = ((buffer->length - index) < count) ? (buffer->length - index) : count;
+    memcpy(data, &buffer->buffer[index], first);
+    memcpy(&data[first], buffer->buffer, count - first);
+    index += count;
+    return (index >= buffer->length) ? (index - buffer->length) : index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_publish
+//
+/* Makes written bytes visible to the reader and wakes it if it waits for them.
+ * @param   buffer : pointer to @ref cy_stream_buffer_t
+ * @param   head   : index of the byte after the last one written
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_rtos_stream_buffer_publish(cy_stream_buffer_t* buffer, uint32_t head)
+{
+    // The bytes are written before the reader can see them
+    cy_rtos_memory_barrier();
+    buffer->head = head;
+
+    // The writer stores head before it reads reader_waiting, and the reader stores
+    // reader_waiting before it reads head, so at least one of them sees the other
+    cy_rtos_memory_barrier();
+    if (buffer->reader_waiting && (cy_rtos_stream_buffer_used(buffer) >= buffer->trigger_level))
+    {
+        buffer->reader_waiting = false;
+        (void)cy_rtos_semaphore_set(&buffer->data);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_release
+//
+/* Hands read bytes back to the writer and wakes it if it waits for space.
+ * @param   buffer : pointer to @ref cy_stream_buffer_t
+ * @param   tail   : index of the byte after the last one read
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_rtos_stream_buffer_release(cy_stream_buffer_t* buffer, uint32_t tail)
+{
+    // The bytes are read before the writer can reuse their memory
+    cy_rtos_memory_barrier();
+    buffer->tail = tail;
+
+    cy_rtos_memory_barrier();
+    if (buffer->writer_waiting)
+    {
+        buffer->writer_waiting = false;
+        (void)cy_rtos_semaphore_set(&buffer->space);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_wait
+//
+/* Blocks the reader until the buffer holds enough bytes, or the writer until it has enough
+ * space, or until the timeout expires.
+ * @param   buffer     : pointer to @ref cy_stream_buffer_t
+ * @param   for_space  : true to wait for free bytes, false to wait for written bytes
+ * @param   needed     : number of bytes to wait for
+ * @param   timeout_ms : maximum time to wait
+ * @return  number of free or written bytes, below needed if the timeout expired
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_rtos_stream_buffer_wait(cy_stream_buffer_t* buffer, bool for_space,
+                                           uint32_t needed, cy_time_t timeout_ms)
+{
+    volatile bool*  waiting = for_space ? &buffer->writer_waiting : &buffer->reader_waiting;
+    cy_semaphore_t* wakeup  = for_space ? &buffer->space : &buffer->data;
+
+    cy_time_t start;
+    cy_rtos_time_get(&start);
+    cy_time_t remaining = timeout_ms;
+    uint32_t  available;
+    while (true)
+    {
+        *waiting = true;
+        cy_rtos_memory_barrier();
+        available = for_space
+            ? cy_rtos_stream_buffer_free(buffer)
+            : cy_rtos_stream_buffer_used(buffer);
+        if ((available >= needed) || (remaining == 0))
+        {
+            break;
+        }
+
+        // Wakeups left over from earlier waits only cost another check
+        (void)cy_rtos_semaphore_get(wakeup, remaining);
+        if (timeout_ms != CY_RTOS_NEVER_TIMEOUT)
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            cy_time_t elapsed = now - start;
+            remaining = (elapsed >= timeout_ms) ? 0 : (timeout_ms - elapsed);
+        }
+    }
+    *waiting = false;
+    return available;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_start
+//
+/* Sets up a buffer in storage.
+ * @param   buffer        : pointer to @ref cy_stream_buffer_t
+ * @param   size          : number of bytes the buffer can hold
+ * @param   trigger_level : bytes needed to wake a waiting reader
+ * @param   storage       : memory of @ref CY_RTOS_STREAM_BUFFER_STORAGE_SIZE bytes
+ * @return  the status of the init
+ */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_rtos_stream_buffer_start(cy_stream_buffer_t* buffer, size_t size,
+                                             size_t trigger_level, void* storage)
+{
+    cy_rslt_t result = cy_rtos_semaphore_init(&buffer->data, 1, 0);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    result = cy_rtos_semaphore_init(&buffer->space, 1, 0);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        (void)cy_rtos_semaphore_deinit(&buffer->data);
+        return result;
+    }
+
+    buffer->buffer         = (uint8_t*)storage;
+    buffer->mem            = NULL;
+    buffer->length         = (uint32_t)size + 1U;
+    buffer->trigger_level  = (trigger_level == 0) ? 1U : (uint32_t)trigger_level;
+    buffer->head           = 0;
+    buffer->tail           = 0;
+    buffer->reader_waiting = false;
+    buffer->writer_waiting = false;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_init_static(cy_stream_buffer_t* buffer, size_t size,
+                                            size_t trigger_level, void* storage)
+{
+    if ((buffer == NULL) || (storage == NULL) || (size == 0) || (size >= UINT32_MAX) ||
+        (trigger_level > size))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if (0 != (((uintptr_t)storage) & CY_RTOS_ALIGNMENT_MASK))
+    {
+        return CY_RTOS_ALIGNMENT_ERROR;
+    }
+    return cy_rtos_stream_buffer_start(buffer, size, trigger_level, storage);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_init(cy_stream_buffer_t* buffer, size_t size,
+                                     size_t trigger_level)
+{
+    if ((buffer == NULL) || (size == 0) || (size >= UINT32_MAX) || (trigger_level > size))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    void* mem = malloc(CY_RTOS_STREAM_BUFFER_STORAGE_SIZE(size));
+    if (mem == NULL)
+    {
+        return CY_RTOS_NO_MEMORY;
+    }
+
+    cy_rslt_t result = cy_rtos_stream_buffer_start(buffer, size, trigger_level, mem);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        free(mem);
+        return result;
+    }
+    buffer->mem = mem;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_send
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_send(cy_stream_buffer_t* buffer, const void* data, size_t length,
+                                     size_t* num_sent, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (data == NULL) || (length == 0) ||
+        (is_in_isr() && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t         sent  = 0;
+    cy_time_t      start;
+    cy_rtos_time_get(&start);
+    while (true)
+    {
+        // The bytes are written as space frees up, so the reader can start on them
+        uint32_t space = cy_rtos_stream_buffer_free(buffer);
+        uint32_t count = ((length - sent) < space) ? (uint32_t)(length - sent) : space;
+        if (count != 0)
+        {
+            uint32_t head = cy_rtos_stream_buffer_copy_in(buffer, buffer->head, &bytes[sent],
+                                                          count);
+            cy_rtos_stream_buffer_publish(buffer, head);
+            sent += count;
+        }
+        if (sent == length)
+        {
+            break;
+        }
+
+        cy_time_t remaining = timeout_ms;
+        if ((timeout_ms != 0) && (timeout_ms != CY_RTOS_NEVER_TIMEOUT))
+        {
+            cy_time_t now;
+            cy_rtos_time_get(&now);
+            cy_time_t elapsed = now - start;
+            remaining = (elapsed >= timeout_ms) ? 0 : (timeout_ms - elapsed);
+        }
+        if ((remaining == 0) || (cy_rtos_stream_buffer_wait(buffer, true, 1U, remaining) == 0))
+        {
+            break;
+        }
+    }
+
+    if (num_sent != NULL)
+    {
+        *num_sent = sent;
+    }
+    return (sent == 0) ? CY_RTOS_QUEUE_FULL : CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_receive
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_receive(cy_stream_buffer_t* buffer, void* data, size_t length,
+                                        size_t* num_received, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (data == NULL) || (length == 0) ||
+        (is_in_isr() && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t available = cy_rtos_stream_buffer_used(buffer);
+    if ((available < buffer->trigger_level) && (timeout_ms != 0))
+    {
+        available = cy_rtos_stream_buffer_wait(buffer, false, buffer->trigger_level, timeout_ms);
+    }
+    uint32_t count = (available < length) ? available : (uint32_t)length;
+    if (num_received != NULL)
+    {
+        *num_received = count;
+    }
+    if (count == 0)
+    {
+        return CY_RTOS_QUEUE_EMPTY;
+    }
+
+    // The bytes are read after head showed they were written
+    cy_rtos_memory_barrier();
+    uint32_t tail = cy_rtos_stream_buffer_copy_out(buffer, buffer->tail, (uint8_t*)data, count);
+    cy_rtos_stream_buffer_release(buffer, tail);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_count(cy_stream_buffer_t* buffer, size_t* num_bytes)
+{
+    if ((buffer == NULL) || (num_bytes == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    *num_bytes = cy_rtos_stream_buffer_used(buffer);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_stream_buffer_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_stream_buffer_deinit(cy_stream_buffer_t* buffer)
+{
+    if (buffer == NULL)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    cy_rslt_t result = cy_rtos_semaphore_deinit(&buffer->space);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cy_rtos_semaphore_deinit(&buffer->data);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        free(buffer->mem);
+        buffer->mem    = NULL;
+        buffer->buffer = NULL;
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_init_static
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_init_static(cy_message_buffer_t* buffer, size_t size,
+                                             void* storage)
+{
+    // Any message wakes the reader, which then reads it whole
+    return (size <= CY_RTOS_MESSAGE_LENGTH_SIZE)
+        ? CY_RTOS_BAD_PARAM
+        : cy_rtos_stream_buffer_init_static(buffer, size, 1U, storage);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_init(cy_message_buffer_t* buffer, size_t size)
+{
+    return (size <= CY_RTOS_MESSAGE_LENGTH_SIZE)
+        ? CY_RTOS_BAD_PARAM
+        : cy_rtos_stream_buffer_init(buffer, size, 1U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_send
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_send(cy_message_buffer_t* buffer, const void* message,
+                                      size_t length, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (message == NULL) || (length == 0) ||
+        (is_in_isr() && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if (length > ((buffer->length - 1U) - CY_RTOS_MESSAGE_LENGTH_SIZE))
+    {
+        return CY_RTOS_QUEUE_FULL;
+    }
+
+    uint32_t needed = (uint32_t)(length + CY_RTOS_MESSAGE_LENGTH_SIZE);
+    uint32_t space  = cy_rtos_stream_buffer_free(buffer);
+    if ((space < needed) && (timeout_ms != 0))
+    {
+        space = cy_rtos_stream_buffer_wait(buffer, true, needed, timeout_ms);
+    }
+    if (space < needed)
+    {
+        return CY_RTOS_QUEUE_FULL;
+    }
+
+    // The length and the message are published together, so the reader never sees part of one
+    uint32_t head = cy_rtos_stream_buffer_copy_in(buffer, buffer->head, (const uint8_t*)&length,
+                                                  CY_RTOS_MESSAGE_LENGTH_SIZE);
+    head = cy_rtos_stream_buffer_copy_in(buffer, head, (const uint8_t*)message, (uint32_t)length);
+    cy_rtos_stream_buffer_publish(buffer, head);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_receive
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_receive(cy_message_buffer_t* buffer, void* message,
+                                         size_t max_length, size_t* length, cy_time_t timeout_ms)
+{
+    if ((buffer == NULL) || (message == NULL) || (length == NULL) ||
+        (is_in_isr() && (timeout_ms != 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    *length = 0;
+    uint32_t available = cy_rtos_stream_buffer_used(buffer);
+    if ((available == 0) && (timeout_ms != 0))
+    {
+        available = cy_rtos_stream_buffer_wait(buffer, false, 1U, timeout_ms);
+    }
+    if (available == 0)
+    {
+        return CY_RTOS_QUEUE_EMPTY;
+    }
+
+    // The message is read after head showed it was written
+    cy_rtos_memory_barrier();
+    size_t   message_length;
+    uint32_t tail = cy_rtos_stream_buffer_copy_out(buffer, buffer->tail,
+                                                   (uint8_t*)&message_length,
+                                                   CY_RTOS_MESSAGE_LENGTH_SIZE);
+    if (message_length > max_length)
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    tail = cy_rtos_stream_buffer_copy_out(buffer, tail, (uint8_t*)message,
+                                          (uint32_t)message_length);
+    cy_rtos_stream_buffer_release(buffer, tail);
+    *length = message_length;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_message_buffer_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_message_buffer_deinit(cy_message_buffer_t* buffer)
+{
+    return cy_rtos_stream_buffer_deinit(buffer);
+}
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // !defined(CY_RTOS_NATIVE_STREAM_BUFFER)